@@ -0,0 +1,128 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+
+#include "AssetPinTable.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "VisualU.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pinned Assets"), STAT_PinnedAssets, STATGROUP_VisualU);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Asset Requests"), STAT_AssetRequests, STATGROUP_VisualU);
+
+FAssetPinTable::FAssetPinTable()
+	: Pins(),
+	PinnedBytes(0)
+{
+}
+
+TSharedPtr<FStreamableHandle> FAssetPinTable::Pin(TConstArrayView<FSoftObjectPath> Paths, const FString& DebugName)
+{
+	FStreamableManager& StreamableManager = UAssetManager::GetStreamableManager();
+
+	TArray<TSharedPtr<FStreamableHandle>> Handles;
+	Handles.Reserve(Paths.Num());
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		if (Path.IsNull())
+		{
+			continue;
+		}
+
+		FPinnedAsset& PinnedAsset = Pins.FindOrAdd(Path);
+		if (PinnedAsset.PinCount++ == 0)
+		{
+			INC_DWORD_STAT(STAT_AssetRequests);
+			PinnedAsset.Handle = StreamableManager.RequestAsyncLoad(
+				Path,
+				FStreamableDelegate(),
+				FStreamableManager::DefaultAsyncLoadPriority,
+				/*bManageActiveHandle=*/false,
+				/*bStartStalled=*/false,
+				DebugName);
+		}
+
+		if (PinnedAsset.Handle.IsValid())
+		{
+			Handles.Add(PinnedAsset.Handle);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_PinnedAssets, Pins.Num());
+
+	if (Handles.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	/*Handles of single assets are shared between scenes, so delegates are bound to the combined one*/
+	return StreamableManager.CreateCombinedHandle(Handles, DebugName);
+}
+
+void FAssetPinTable::Unpin(TConstArrayView<FSoftObjectPath> Paths)
+{
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		FPinnedAsset* PinnedAsset = Pins.Find(Path);
+		if (!PinnedAsset)
+		{
+			continue;
+		}
+
+		if (--PinnedAsset->PinCount <= 0)
+		{
+			if (PinnedAsset->Handle.IsValid())
+			{
+				PinnedAsset->Handle->CancelHandle();
+			}
+
+			if (PinnedAsset->SizeBytes != INDEX_NONE)
+			{
+				PinnedBytes -= PinnedAsset->SizeBytes;
+			}
+
+			Pins.Remove(Path);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_PinnedAssets, Pins.Num());
+}
+
+void FAssetPinTable::Empty()
+{
+	for (TPair<FSoftObjectPath, FPinnedAsset>& Pin : Pins)
+	{
+		if (Pin.Value.Handle.IsValid())
+		{
+			Pin.Value.Handle->CancelHandle();
+		}
+	}
+
+	Pins.Empty();
+	PinnedBytes = 0;
+
+	SET_DWORD_STAT(STAT_PinnedAssets, 0);
+}
+
+int64 FAssetPinTable::Measure()
+{
+	for (TPair<FSoftObjectPath, FPinnedAsset>& Pin : Pins)
+	{
+		FPinnedAsset& PinnedAsset = Pin.Value;
+		if (PinnedAsset.SizeBytes != INDEX_NONE || (PinnedAsset.Handle.IsValid() && !PinnedAsset.Handle->HasLoadCompleted()))
+		{
+			continue;
+		}
+
+		const UObject* LoadedAsset = Pin.Key.ResolveObject();
+		PinnedAsset.SizeBytes = LoadedAsset ? LoadedAsset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal) : 0;
+		PinnedBytes += PinnedAsset.SizeBytes;
+	}
+
+	return PinnedBytes;
+}
+
+int32 FAssetPinTable::GetPinCount(const FSoftObjectPath& Path) const
+{
+	const FPinnedAsset* PinnedAsset = Pins.Find(Path);
+	return PinnedAsset ? PinnedAsset->PinCount : 0;
+}
@@ -40,6 +40,7 @@ void FGameplayDebuggerCategory_VisualU::FRepData::Serialize(FArchive& Ar)
 	Ar.SerializeBits(&bControllerPlaysSound, 1);
 	Ar.SerializeBits(&bControllerPlaysTransitions, 1);
 	Ar << NumScenesToLoad;
+	Ar << PrefetchHitRate;
 	Ar << ExhaustedScenesDesc;
 	Ar << AsyncQueueDesc;
 }
@@ -84,6 +85,7 @@ void FGameplayDebuggerCategory_VisualU::CollectData(APlayerController* OwnerPC,
 				RepData.bControllerPlaysSound = VisualController->PlaysSound();
 				RepData.bControllerPlaysTransitions = VisualController->PlaysTransitions();
 				RepData.NumScenesToLoad = VisualController->GetNumScenesToLoad();
+				RepData.PrefetchHitRate = VisualController->GetPrefetchHitRate();
 				RepData.ExhaustedScenesDesc = VisualController->GetExhaustedScenesDebugString();
 				RepData.AsyncQueueDesc = VisualController->GetAsyncQueueDebugString();
 			}
@@ -112,6 +114,7 @@ void FGameplayDebuggerCategory_VisualU::DrawData(APlayerController* OwnerPC, FGa
 		CanvasContext.Printf(TEXT("{cyan}Controller plays sound: {magenta}%s"), RepData.bControllerPlaysSound ? TEXT("true") : TEXT("false"));
 		CanvasContext.Printf(TEXT("{cyan}Controller plays transitions: {magenta}%s"), RepData.bControllerPlaysTransitions ? TEXT("true") : TEXT("false"));
 		CanvasContext.Printf(TEXT("{cyan}Controller number of scenarios to load: {magenta}%i"), RepData.NumScenesToLoad);
+		CanvasContext.Printf(TEXT("{cyan}Controller prefetch hit rate: {magenta}%.2f"), RepData.PrefetchHitRate);
 		CanvasContext.Printf(TEXT("{cyan}[Exhausted scenarios]\n{magenta}%s"), *RepData.ExhaustedScenesDesc);
 		CanvasContext.Printf(TEXT("{cyan}[Asynchronous queue]\n{magenta}%s"), *RepData.AsyncQueueDesc);
 
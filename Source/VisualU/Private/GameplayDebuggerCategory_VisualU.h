@@ -40,6 +40,7 @@ private:
 		bool bControllerPlaysSound;
 		bool bControllerPlaysTransitions;
 		int32 NumScenesToLoad;
+		float PrefetchHitRate;
 		FString ExhaustedScenesDesc;
 		FString AsyncQueueDesc;
 
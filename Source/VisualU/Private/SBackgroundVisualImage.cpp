@@ -6,7 +6,6 @@
 #include "PaperFlipbook.h"
 #include "VisualUSettings.h"
 #include "Materials/MaterialInstanceDynamic.h"
-#include "ME_TransitionParameter2D.h"
 #include "Engine/Texture.h"
 #include "Animation/CurveSequence.h"
 
@@ -23,7 +22,11 @@ SBackgroundVisualImage::SBackgroundVisualImage()
 	Target(*this),
 	bIsTransitioning(false),
 	bIsTargetAnimated(false),
-	TargetFrameIndex(0)
+	TargetFrameIndex(0),
+	TransitionSprite(nullptr),
+	TransitionTargetSprite(nullptr),
+	BoundATexture(nullptr),
+	BoundBTexture(nullptr)
 {
 }
 
@@ -50,6 +53,7 @@ void SBackgroundVisualImage::StartTransition(UPaperFlipbook* TargetFlipbook, UMa
 	bIsTransitioning = true;
 	bIsTargetAnimated = bShouldAnimateTarget;
 	TargetFrameIndex = 0;
+	ResetTransitionBindings();
 }
 
 void SBackgroundVisualImage::StartTransition(UPaperFlipbook* TargetFlipbook, UMaterialInstanceDynamic* TransitionMaterial, int32 FrameIndex)
@@ -62,6 +66,7 @@ void SBackgroundVisualImage::StartTransition(UPaperFlipbook* TargetFlipbook, UMa
 
 	bIsTransitioning = true;
 	bIsTargetAnimated = false;
+	ResetTransitionBindings();
 }
 
 void SBackgroundVisualImage::StopTransition()
@@ -69,6 +74,7 @@ void SBackgroundVisualImage::StopTransition()
 	SetFlipbook(Target.Get());
 	bIsTransitioning = false;
 	UpdateSequence();
+	ResetTransitionBindings();
 }
 
 void SBackgroundVisualImage::AddReferencedObjects(FReferenceCollector& Collector)
@@ -89,18 +95,50 @@ FString SBackgroundVisualImage::GetReferencerName() const
 
 UObject* SBackgroundVisualImage::GetFinalResource() const
 {
-	if (bIsTransitioning && Transition.Get())
+	if (UMaterialInstanceDynamic* TransitionMaterial = Transition.Get(); bIsTransitioning && TransitionMaterial)
 	{
+		TransitionSprite = GetCurrentSprite();
+		TransitionTargetSprite = GetTargetSprite();
+
+		/*Frames of the flipbook often share the texture, so parameters are rarely set*/
 		const UVisualUSettings* VisualUSettings = GetDefault<UVisualUSettings>();
-		TMap<FName, UTexture*> Params;
-		Params.Add(VisualUSettings->AParameterName, GetCurrentSprite()->GetBakedTexture());
-		Params.Add(VisualUSettings->BParameterName, GetTargetSprite()->GetBakedTexture());
-		return UME_TransitionParameter2D::GetTransitionMaterial(Transition.Get(), Params);
+		if (UTexture* ATexture = TransitionSprite->GetBakedTexture(); ATexture != BoundATexture)
+		{
+			TransitionMaterial->SetTextureParameterValue(VisualUSettings->AParameterName, ATexture);
+			BoundATexture = ATexture;
+		}
+
+		if (UTexture* BTexture = TransitionTargetSprite->GetBakedTexture(); BTexture != BoundBTexture)
+		{
+			TransitionMaterial->SetTextureParameterValue(VisualUSettings->BParameterName, BTexture);
+			BoundBTexture = BTexture;
+		}
+
+		return TransitionMaterial;
 	}
 
 	return GetCurrentSprite();
 }
 
+bool SBackgroundVisualImage::IsBrushOutdated(const FSlateBrush& Brush) const
+{
+	if (bIsTransitioning && Transition.Get())
+	{
+		return (GetAnimate() || bIsTargetAnimated) && (GetCurrentSprite() != TransitionSprite || GetTargetSprite() != TransitionTargetSprite);
+	}
+
+	return Super::IsBrushOutdated(Brush);
+}
+
+void SBackgroundVisualImage::ResetTransitionBindings()
+{
+	TransitionSprite = nullptr;
+	TransitionTargetSprite = nullptr;
+	BoundATexture = nullptr;
+	BoundBTexture = nullptr;
+	InvalidateBrush();
+}
+
 UPaperSprite* SBackgroundVisualImage::GetTargetSprite() const
 {
 	if (UPaperFlipbook* TargetFlipbook = Target.Get())
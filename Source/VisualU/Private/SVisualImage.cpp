@@ -72,16 +72,19 @@ TSharedRef<FSlateAccessibleWidget> SVisualImage::CreateAccessibleWidget()
 void SVisualImage::SetAnimate(bool IsAnimated)
 {
 	bAnimate = IsAnimated;
+	InvalidateBrush();
 }
 
 void SVisualImage::SetSpriteIndex(int32 Index)
 {
 	SpriteIndex = Index;
+	InvalidateBrush();
 }
 
 void SVisualImage::SetFlipbook(UPaperFlipbook* InFlipbook)
 {
 	Flipbook.Set(*this, InFlipbook);
+	InvalidateBrush();
 
 	UpdateSequence();
 }
@@ -89,6 +92,7 @@ void SVisualImage::SetFlipbook(UPaperFlipbook* InFlipbook)
 void SVisualImage::SetFlipbook(TAttribute<const UPaperFlipbook*> InFlipbook)
 {
 	Flipbook.Assign(*this, MoveTemp(InFlipbook));
+	InvalidateBrush();
 
 	UpdateSequence();
 }
@@ -154,7 +158,7 @@ UPaperSprite* SVisualImage::GetCurrentSprite() const
 
 FVector2D SVisualImage::ComputeDesiredSize(float) const
 {
-	const FSlateBrush Brush = ConvertToBrush();
+	const FSlateBrush& Brush = GetBrush();
 
 	return CustomDesiredScale.Get().IsSet() ? CustomDesiredScale.Get().GetValue() * Brush.GetImageSize() : Brush.GetImageSize();
 }
@@ -192,9 +196,15 @@ const FVector2D SVisualImage::GetImageSize() const
 	return FVector2D(BoxSize.X, BoxSize.Z);
 }
 
+bool SVisualImage::IsBrushOutdated(const FSlateBrush& Brush) const
+{
+	/*Animated flipbook changes its sprite over time, so the brush is compared instead of invalidated*/
+	return Brush.GetResourceObject() != GetCurrentSprite();
+}
+
 const FLinearColor SVisualImage::GetFinalColorAndOpacity(const FWidgetStyle& InWidgetStyle) const
 {
-	return FLinearColor(InWidgetStyle.GetColorAndOpacityTint() * ColorAndOpacity.ToAttribute(*this).Get().GetColor(InWidgetStyle) * ConvertToBrush().GetTint(InWidgetStyle));
+	return FLinearColor(InWidgetStyle.GetColorAndOpacityTint() * ColorAndOpacity.ToAttribute(*this).Get().GetColor(InWidgetStyle) * GetBrush().GetTint(InWidgetStyle));
 }
 
 void SVisualImage::PreSlateDrawElementExtension() const
@@ -3,10 +3,47 @@
 
 #include "Scenario.h"
 
+DECLARE_CYCLE_STAT(TEXT("Intrude All Scenes"), STAT_IntrudeAll, STATGROUP_VisualU);
+
 FSprite::FSprite() : Position(ForceInit), ZOrder(ForceInit) {};
 
 FBackground::FBackground() = default;
 
 FVisualScenarioInfo::FVisualScenarioInfo() = default;
 
-FScenario::FScenario() = default;
+FScenario::FScenario() : Owner(nullptr), Index(INDEX_NONE) {};
+
+void FScenario::Intrude(const UDataTable* InDataTable)
+{
+	check(InDataTable);
+
+	/*Rows are notified in order, the first one starts a new batch of changes*/
+	const TMap<FName, uint8*>& RowMap = InDataTable->GetRowMap();
+	if (!RowMap.IsEmpty() && RowMap.CreateConstIterator().Value() == reinterpret_cast<const uint8*>(this))
+	{
+		IntrudeAll(InDataTable);
+	}
+	else if (Owner != InDataTable || Index == INDEX_NONE)
+	{
+		/*Row was not part of the batch, i.e. it was changed on its own*/
+		FScenarioNodeCache& NodeCache = FScenarioNodeCache::Get();
+		Owner = InDataTable;
+		Index = NodeCache.FindIndex(InDataTable, this);
+	}
+}
+
+void FScenario::IntrudeAll(const UDataTable* InDataTable)
+{
+	SCOPE_CYCLE_COUNTER(STAT_IntrudeAll);
+	check(InDataTable);
+
+	FScenarioNodeCache::Get().Invalidate(InDataTable);
+
+	int32 RowIndex = 0;
+	for (const TPair<FName, uint8*>& Row : InDataTable->GetRowMap())
+	{
+		FScenario* Scene = reinterpret_cast<FScenario*>(Row.Value);
+		Scene->Owner = InDataTable;
+		Scene->Index = RowIndex++;
+	}
+}
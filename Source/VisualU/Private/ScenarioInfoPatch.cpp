@@ -0,0 +1,182 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+
+#include "ScenarioInfoPatch.h"
+
+namespace UE::VisualU::Private
+{
+	bool AreTextsIdentical(const FText& A, const FText& B)
+	{
+		return A.IdenticalTo(B, ETextIdenticalModeFlags::DeepCompare | ETextIdenticalModeFlags::LexicalCompareInvariants);
+	}
+
+	SIZE_T GetTextSize(const FText& Text)
+	{
+		return Text.IsEmpty() ? 0 : Text.ToString().GetAllocatedSize();
+	}
+}
+
+FScenarioInfoPatch::FScenarioInfoPatch()
+	: Members(EScenarioInfoMembers::None),
+	Values()
+{
+}
+
+FScenarioInfoPatch::FScenarioInfoPatch(const FVisualScenarioInfo& Info, EScenarioInfoMembers InMembers)
+	: Members(InMembers),
+	Values()
+{
+	if (EnumHasAnyFlags(Members, EScenarioInfoMembers::Author))
+	{
+		Values.Author = Info.Author;
+	}
+
+	if (EnumHasAnyFlags(Members, EScenarioInfoMembers::Line))
+	{
+		Values.Line = Info.Line;
+	}
+
+	if (EnumHasAnyFlags(Members, EScenarioInfoMembers::Sound))
+	{
+		Values.Sound = Info.Sound;
+	}
+
+	if (EnumHasAnyFlags(Members, EScenarioInfoMembers::Background))
+	{
+		Values.Background = Info.Background;
+	}
+
+	if (EnumHasAnyFlags(Members, EScenarioInfoMembers::SpritesParams))
+	{
+		Values.SpritesParams = Info.SpritesParams;
+	}
+
+	if (EnumHasAnyFlags(Members, EScenarioInfoMembers::Flags))
+	{
+		Values.Flags = Info.Flags;
+	}
+}
+
+FScenarioInfoPatch FScenarioInfoPatch::Diff(const FVisualScenarioInfo& From, const FVisualScenarioInfo& To)
+{
+	using namespace UE::VisualU::Private;
+
+	EScenarioInfoMembers ChangedMembers = EScenarioInfoMembers::None;
+	if (!AreTextsIdentical(From.Author, To.Author))
+	{
+		ChangedMembers |= EScenarioInfoMembers::Author;
+	}
+
+	if (!AreTextsIdentical(From.Line, To.Line))
+	{
+		ChangedMembers |= EScenarioInfoMembers::Line;
+	}
+
+	if (From.Sound != To.Sound)
+	{
+		ChangedMembers |= EScenarioInfoMembers::Sound;
+	}
+
+	if (From.Background != To.Background)
+	{
+		ChangedMembers |= EScenarioInfoMembers::Background;
+	}
+
+	if (From.SpritesParams != To.SpritesParams)
+	{
+		ChangedMembers |= EScenarioInfoMembers::SpritesParams;
+	}
+
+	if (From.Flags != To.Flags)
+	{
+		ChangedMembers |= EScenarioInfoMembers::Flags;
+	}
+
+	return FScenarioInfoPatch(From, ChangedMembers);
+}
+
+void FScenarioInfoPatch::Apply(FVisualScenarioInfo& Info) const
+{
+	if (EnumHasAnyFlags(Members, EScenarioInfoMembers::Author))
+	{
+		Info.Author = Values.Author;
+	}
+
+	if (EnumHasAnyFlags(Members, EScenarioInfoMembers::Line))
+	{
+		Info.Line = Values.Line;
+	}
+
+	if (EnumHasAnyFlags(Members, EScenarioInfoMembers::Sound))
+	{
+		Info.Sound = Values.Sound;
+	}
+
+	if (EnumHasAnyFlags(Members, EScenarioInfoMembers::Background))
+	{
+		Info.Background = Values.Background;
+	}
+
+	if (EnumHasAnyFlags(Members, EScenarioInfoMembers::SpritesParams))
+	{
+		Info.SpritesParams = Values.SpritesParams;
+	}
+
+	if (EnumHasAnyFlags(Members, EScenarioInfoMembers::Flags))
+	{
+		Info.Flags = Values.Flags;
+	}
+}
+
+SIZE_T FScenarioInfoPatch::GetAllocatedSize() const
+{
+	using namespace UE::VisualU::Private;
+
+	SIZE_T Size = sizeof(FScenarioInfoPatch) + GetTextSize(Values.Author) + GetTextSize(Values.Line);
+	Size += Values.SpritesParams.GetAllocatedSize();
+	for (const FSprite& Sprite : Values.SpritesParams)
+	{
+		Size += Sprite.SpriteInfo.GetAllocatedSize();
+	}
+
+	return Size;
+}
+
+FArchive& operator<<(FArchive& Ar, FScenarioInfoPatch& Patch)
+{
+	uint8 Members = StaticCast<uint8>(Patch.Members);
+	Ar << Members;
+	Patch.Members = StaticCast<EScenarioInfoMembers>(Members) & EScenarioInfoMembers::All;
+
+	if (EnumHasAnyFlags(Patch.Members, EScenarioInfoMembers::Author))
+	{
+		Ar << Patch.Values.Author;
+	}
+
+	if (EnumHasAnyFlags(Patch.Members, EScenarioInfoMembers::Line))
+	{
+		Ar << Patch.Values.Line;
+	}
+
+	if (EnumHasAnyFlags(Patch.Members, EScenarioInfoMembers::Sound))
+	{
+		Ar << Patch.Values.Sound;
+	}
+
+	if (EnumHasAnyFlags(Patch.Members, EScenarioInfoMembers::Background))
+	{
+		Ar << Patch.Values.Background;
+	}
+
+	if (EnumHasAnyFlags(Patch.Members, EScenarioInfoMembers::SpritesParams))
+	{
+		Ar << Patch.Values.SpritesParams;
+	}
+
+	if (EnumHasAnyFlags(Patch.Members, EScenarioInfoMembers::Flags))
+	{
+		Ar << Patch.Values.Flags;
+	}
+
+	return Ar;
+}
@@ -0,0 +1,124 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+
+#include "ScenarioNodeCache.h"
+#include "Engine/DataTable.h"
+#include "Scenario.h"
+
+FScenarioNodeCache::FNodeEntry::FNodeEntry(const UDataTable* InNode)
+	: Node(InNode),
+	Scenes(MakeShared<TArray<FScenario*>>()),
+	Positions(),
+	OnNodeChangedHandle()
+{
+	check(InNode);
+	InNode->GetAllRows(UE_SOURCE_LOCATION, Scenes.Get());
+
+	Positions.Reserve(Scenes->Num());
+	for (int32 i = 0; i < Scenes->Num(); i++)
+	{
+		Positions.Add((*Scenes)[i], i);
+	}
+}
+
+FScenarioNodeCache& FScenarioNodeCache::Get()
+{
+	static FScenarioNodeCache Cache;
+	return Cache;
+}
+
+TSharedRef<const TArray<FScenario*>> FScenarioNodeCache::GetScenes(const UDataTable* Node)
+{
+	return FindOrAdd(Node).Scenes;
+}
+
+FScenario* FScenarioNodeCache::GetSceneAt(const UDataTable* Node, int32 Index)
+{
+	const TArray<FScenario*>& Scenes = FindOrAdd(Node).Scenes.Get();
+
+	return Scenes.IsValidIndex(Index) ? Scenes[Index] : nullptr;
+}
+
+int32 FScenarioNodeCache::FindIndex(const UDataTable* Node, const FScenario* Scene)
+{
+	if (const int32* Position = FindOrAdd(Node).Positions.Find(Scene))
+	{
+		return *Position;
+	}
+
+	/*Row might have been added after the node was indexed*/
+	Invalidate(Node);
+	const int32* Position = FindOrAdd(Node).Positions.Find(Scene);
+
+	return Position ? *Position : INDEX_NONE;
+}
+
+void FScenarioNodeCache::Invalidate(const UDataTable* Node)
+{
+	check(IsInGameThread());
+	const TObjectKey<UDataTable> Key(Node);
+	if (FNodeEntry* Entry = Entries.Find(Key))
+	{
+		if (UDataTable* DataTable = const_cast<UDataTable*>(Entry->Node.Get()))
+		{
+			DataTable->OnDataTableChanged().Remove(Entry->OnNodeChangedHandle);
+		}
+
+		Entries.Remove(Key);
+	}
+}
+
+void FScenarioNodeCache::Reset()
+{
+	check(IsInGameThread());
+	for (TPair<TObjectKey<UDataTable>, FNodeEntry>& Entry : Entries)
+	{
+		if (UDataTable* DataTable = const_cast<UDataTable*>(Entry.Value.Node.Get()))
+		{
+			DataTable->OnDataTableChanged().Remove(Entry.Value.OnNodeChangedHandle);
+		}
+	}
+
+	Entries.Empty();
+}
+
+FScenarioNodeCache::FNodeEntry& FScenarioNodeCache::FindOrAdd(const UDataTable* Node)
+{
+	check(IsInGameThread());
+	check(Node);
+	const TObjectKey<UDataTable> Key(Node);
+	if (FNodeEntry* Entry = Entries.Find(Key))
+	{
+		return *Entry;
+	}
+
+	RemoveStaleEntries();
+
+	FNodeEntry& Entry = Entries.Emplace(Key, FNodeEntry(Node));
+	Entry.OnNodeChangedHandle = const_cast<UDataTable*>(Node)->OnDataTableChanged().AddRaw(this, &FScenarioNodeCache::OnNodeChanged, Key);
+
+	return Entry;
+}
+
+void FScenarioNodeCache::OnNodeChanged(TObjectKey<UDataTable> Key)
+{
+	if (const UDataTable* Node = Key.ResolveObjectPtr())
+	{
+		Invalidate(Node);
+	}
+	else
+	{
+		Entries.Remove(Key);
+	}
+}
+
+void FScenarioNodeCache::RemoveStaleEntries()
+{
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().Node.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
@@ -0,0 +1,207 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+
+#include "SceneResidencyCache.h"
+#include "Engine/StreamableManager.h"
+#include "AssetPinTable.h"
+#include "Scenario.h"
+#include "VisualU.h"
+
+DECLARE_MEMORY_STAT(TEXT("Resident Scene Assets"), STAT_ResidentSceneBytes, STATGROUP_VisualU);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Resident Scenes"), STAT_ResidentScenes, STATGROUP_VisualU);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Released Scenes"), STAT_ReleasedScenes, STATGROUP_VisualU);
+
+FSceneResidencyCache::FSceneKey::FSceneKey(const FScenario* Scene)
+	: Owner(Scene->GetOwner()),
+	Index(Scene->GetIndex())
+{
+}
+
+FSceneResidencyCache::FSceneResidencyCache(FAssetPinTable& InPinTable, int64 InBudget)
+	: PinTable(InPinTable),
+	Entries(),
+	Budget(InBudget),
+	UseCounter(0)
+{
+}
+
+FSceneResidencyCache::~FSceneResidencyCache()
+{
+	Empty();
+}
+
+void FSceneResidencyCache::SetBudget(int64 InBudget)
+{
+	Budget = InBudget;
+}
+
+int64 FSceneResidencyCache::GetResidentBytes() const
+{
+	return PinTable.GetPinnedBytes();
+}
+
+TSharedPtr<FStreamableHandle> FSceneResidencyCache::Add(const FScenario* Scene, int32 Priority)
+{
+	check(Scene);
+	const FSceneKey Key(Scene);
+	FResidentScene* ExistingScene = Entries.Find(Key);
+	FResidentScene& ResidentScene = ExistingScene ? *ExistingScene : Entries.Add(Key);
+	ResidentScene.Priority = ExistingScene ? FMath::Max(ResidentScene.Priority, Priority) : Priority;
+	ResidentScene.LastUse = ++UseCounter;
+
+	if (ResidentScene.Paths.IsEmpty())
+	{
+		TArray<FSoftObjectPath> DataToLoad;
+		Scene->GetDataToLoad(DataToLoad);
+
+		ResidentScene.Paths.Reserve(DataToLoad.Num());
+		for (FSoftObjectPath& Path : DataToLoad)
+		{
+			ResidentScene.Paths.AddUnique(MoveTemp(Path));
+		}
+
+		FString DebugName = TEXT("ResidentScene");
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+		DebugName = Scene->GetDebugString();
+#endif
+		ResidentScene.Handle = PinTable.Pin(ResidentScene.Paths, DebugName);
+	}
+
+	SET_DWORD_STAT(STAT_ResidentScenes, Entries.Num());
+
+	return ResidentScene.Handle;
+}
+
+bool FSceneResidencyCache::Touch(const FScenario* Scene, int32 Priority)
+{
+	check(Scene);
+	if (FResidentScene* ResidentScene = Entries.Find(FSceneKey(Scene)))
+	{
+		ResidentScene->Priority = Priority;
+		ResidentScene->LastUse = ++UseCounter;
+
+		return true;
+	}
+
+	return false;
+}
+
+void FSceneResidencyCache::DemoteAll()
+{
+	for (TPair<FSceneKey, FResidentScene>& Entry : Entries)
+	{
+		Entry.Value.Priority = INDEX_NONE;
+	}
+}
+
+bool FSceneResidencyCache::Contains(const FScenario* Scene) const
+{
+	check(Scene);
+	return Entries.Contains(FSceneKey(Scene));
+}
+
+bool FSceneResidencyCache::IsLoaded(const FScenario* Scene) const
+{
+	check(Scene);
+	const FResidentScene* ResidentScene = Entries.Find(FSceneKey(Scene));
+	return ResidentScene && (!ResidentScene->Handle.IsValid() || ResidentScene->Handle->HasLoadCompleted());
+}
+
+int32 FSceneResidencyCache::Trim(TConstArrayView<const FScenario*> ProtectedScenes)
+{
+	/*Assets that are still pinned by other scenes are not released, so the table is checked after every release*/
+	int32 NumReleased = 0;
+	if (PinTable.Measure() > Budget)
+	{
+		TArray<FSceneKey, TInlineAllocator<16>> ProtectedKeys;
+		ProtectedKeys.Reserve(ProtectedScenes.Num());
+		for (const FScenario* ProtectedScene : ProtectedScenes)
+		{
+			if (ProtectedScene)
+			{
+				ProtectedKeys.Emplace(ProtectedScene);
+			}
+		}
+
+		TArray<FSceneKey, TInlineAllocator<16>> Candidates;
+		Candidates.Reserve(Entries.Num());
+		for (const TPair<FSceneKey, FResidentScene>& Entry : Entries)
+		{
+			const TSharedPtr<FStreamableHandle>& Handle = Entry.Value.Handle;
+			const bool bIsLoading = Handle.IsValid() && !Handle->HasLoadCompleted();
+			if (!bIsLoading && !ProtectedKeys.Contains(Entry.Key))
+			{
+				Candidates.Add(Entry.Key);
+			}
+		}
+
+		Candidates.Sort([this](const FSceneKey& A, const FSceneKey& B)
+		{
+			const FResidentScene& SceneA = Entries.FindChecked(A);
+			const FResidentScene& SceneB = Entries.FindChecked(B);
+
+			return SceneA.Priority != SceneB.Priority
+				? SceneA.Priority < SceneB.Priority
+				: SceneA.LastUse < SceneB.LastUse;
+		});
+
+		for (const FSceneKey& Candidate : Candidates)
+		{
+			if (PinTable.GetPinnedBytes() <= Budget)
+			{
+				break;
+			}
+
+			Release(Entries.FindChecked(Candidate));
+			Entries.Remove(Candidate);
+			NumReleased++;
+		}
+
+		INC_DWORD_STAT_BY(STAT_ReleasedScenes, NumReleased);
+	}
+
+	SET_MEMORY_STAT(STAT_ResidentSceneBytes, PinTable.GetPinnedBytes());
+	SET_DWORD_STAT(STAT_ResidentScenes, Entries.Num());
+
+	return NumReleased;
+}
+
+void FSceneResidencyCache::Empty()
+{
+	for (TPair<FSceneKey, FResidentScene>& Entry : Entries)
+	{
+		Release(Entry.Value);
+	}
+
+	Entries.Empty();
+
+	SET_MEMORY_STAT(STAT_ResidentSceneBytes, PinTable.GetPinnedBytes());
+	SET_DWORD_STAT(STAT_ResidentScenes, 0);
+}
+
+FString FSceneResidencyCache::GetDebugString() const
+{
+	FString DebugString;
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	DebugString = FString::Printf(TEXT("Resident: %.2f MB / %.2f MB\n"), PinTable.GetPinnedBytes() / (1024.0 * 1024.0), Budget / (1024.0 * 1024.0));
+	for (const TPair<FSceneKey, FResidentScene>& Entry : Entries)
+	{
+		const TSharedPtr<FStreamableHandle>& Handle = Entry.Value.Handle;
+		DebugString += FString::Printf(TEXT("%s Progress: %.2f Assets: %i Priority: %i\n"),
+			Handle.IsValid() ? *Handle->GetDebugName() : TEXT("None"),
+			Handle.IsValid() ? Handle->GetProgress() : 1.f,
+			Entry.Value.Paths.Num(),
+			Entry.Value.Priority);
+	}
+#endif
+
+	return DebugString;
+}
+
+void FSceneResidencyCache::Release(FResidentScene& ResidentScene)
+{
+	/*Assets might be pinned by other scenes, pin table decides when they are released*/
+	ResidentScene.Handle.Reset();
+	PinTable.Unpin(ResidentScene.Paths);
+	ResidentScene.Paths.Empty();
+}
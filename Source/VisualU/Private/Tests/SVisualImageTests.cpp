@@ -0,0 +1,115 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+
+#include "Misc/AutomationTest.h"
+#include "Misc/App.h"
+#include "Engine/Texture2D.h"
+#include "Input/HittestGrid.h"
+#include "PaperFlipbook.h"
+#include "PaperSprite.h"
+#include "Rendering/DrawElements.h"
+#include "Styling/WidgetStyle.h"
+#include "Types/PaintArgs.h"
+#include "Widgets/Layout/SConstraintCanvas.h"
+#include "Widgets/SWindow.h"
+#include "SVisualImage.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVisualUPaintVisualImagesTest, "VisualU.VisualImage.Paint", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FVisualUPaintVisualImagesTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumImages = 100;
+	constexpr int32 NumFrames = 200;
+	constexpr int32 ImagesPerRow = 10;
+	constexpr float ImageSize = 64.f;
+
+	UTexture2D* Texture = UTexture2D::CreateTransient(ImageSize, ImageSize);
+	UPaperSprite* Sprite = NewObject<UPaperSprite>(GetTransientPackage(), NAME_None, RF_Transient);
+	FSpriteAssetInitParameters SpriteParams;
+	SpriteParams.SetTextureAndFill(Texture);
+	Sprite->InitializeSprite(SpriteParams);
+
+	UPaperFlipbook* Flipbook = NewObject<UPaperFlipbook>(GetTransientPackage(), NAME_None, RF_Transient);
+	{
+		FScopedFlipbookMutator FlipbookMutator(Flipbook);
+		FPaperFlipbookKeyFrame& KeyFrame = FlipbookMutator.KeyFrames.AddDefaulted_GetRef();
+		KeyFrame.Sprite = Sprite;
+		KeyFrame.FrameRun = 1;
+	}
+
+	const double BuildStartTime = FPlatformTime::Seconds();
+	TSharedRef<SConstraintCanvas> Canvas = SNew(SConstraintCanvas);
+	TArray<TSharedRef<SVisualImage>> Images;
+	Images.Reserve(NumImages);
+	for (int32 i = 0; i < NumImages; i++)
+	{
+		TSharedRef<SVisualImage> Image = SNew(SVisualImage)
+			.Flipbook(Flipbook)
+			.ColorAndOpacity(FLinearColor::White)
+			.MirrorScale(FVector2D(1, 1));
+
+		Canvas->AddSlot()
+			.Offset(FMargin((i % ImagesPerRow) * ImageSize, (i / ImagesPerRow) * ImageSize, ImageSize, ImageSize))
+			[
+				Image
+			];
+
+		Images.Add(Image);
+	}
+	Canvas->SlatePrepass(1.f);
+	const double BuildTime = FPlatformTime::Seconds() - BuildStartTime;
+
+	const FVector2D WindowSize(ImagesPerRow * ImageSize, FMath::DivideAndRoundUp(NumImages, ImagesPerRow) * ImageSize);
+	TSharedRef<SWindow> Window = SNew(SWindow).ClientSize(WindowSize);
+	const FGeometry Geometry = FGeometry::MakeRoot(WindowSize, FSlateLayoutTransform());
+	const FSlateRect CullingRect(FVector2D::ZeroVector, WindowSize);
+	FHittestGrid HittestGrid;
+
+	/*Rebuilt brushes stand for the paint before caching, when every paint converted the sprite to a brush*/
+	const auto PaintFrames = [&](bool bRebuildBrushes) -> double
+	{
+		double PaintTime = 0.0;
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			if (bRebuildBrushes)
+			{
+				for (const TSharedRef<SVisualImage>& Image : Images)
+				{
+					Image->SetSpriteIndex(0);
+				}
+			}
+
+			FSlateWindowElementList ElementList(Window);
+			FPaintArgs PaintArgs(nullptr, HittestGrid, FVector2D::ZeroVector, FApp::GetCurrentTime(), FApp::GetDeltaTime());
+
+			const double PaintStartTime = FPlatformTime::Seconds();
+			Canvas->Paint(PaintArgs, Geometry, CullingRect, ElementList, 0, FWidgetStyle(), /*bParentEnabled=*/true);
+			PaintTime += FPlatformTime::Seconds() - PaintStartTime;
+		}
+
+		return PaintTime / NumFrames;
+	};
+
+	/*Warm up, so that both runs start with converted brushes*/
+	PaintFrames(false);
+
+	const double RebuiltPaintTime = PaintFrames(true);
+	const double CachedPaintTime = PaintFrames(false);
+
+	AddInfo(FString::Printf(TEXT("%d visual images: built in %.3f ms, painted in %.3f ms per frame with rebuilt brushes and %.3f ms with cached brushes."),
+		NumImages,
+		BuildTime * 1000.0,
+		RebuiltPaintTime * 1000.0,
+		CachedPaintTime * 1000.0));
+
+	if (CachedPaintTime > RebuiltPaintTime)
+	{
+		AddWarning(TEXT("Paint with cached brushes is not faster than paint with rebuilt brushes."));
+	}
+
+	return true;
+}
+
+#endif
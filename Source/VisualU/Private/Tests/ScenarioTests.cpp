@@ -0,0 +1,90 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+
+#include "Misc/AutomationTest.h"
+#include "Engine/DataTable.h"
+#include "Scenario.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+namespace UE::VisualU::Tests::Private
+{
+	/**
+	* Builds JSON source of a node with the given number of scenes.
+	*/
+	FString MakeNodeJSON(int32 NumScenes)
+	{
+		FString JSON = TEXT("[");
+		for (int32 i = 0; i < NumScenes; i++)
+		{
+			JSON += FString::Printf(TEXT("%s{\"Name\":\"Scene_%d\",\"Info\":{\"Line\":\"Line %d\"},\"ChoiceTargets\":[]}"), i > 0 ? TEXT(",") : TEXT(""), i, i);
+		}
+		JSON += TEXT("]");
+
+		return JSON;
+	}
+
+	/**
+	* Imports the node several times and keeps the fastest run to filter out noise.
+	*
+	* @return seconds spent by the fastest import
+	*/
+	double TimeImport(FAutomationTestBase& Test, int32 NumScenes, int32 NumRuns)
+	{
+		const FString JSON = MakeNodeJSON(NumScenes);
+		double BestTime = TNumericLimits<double>::Max();
+		for (int32 Run = 0; Run < NumRuns; Run++)
+		{
+			UDataTable* DataTable = NewObject<UDataTable>(GetTransientPackage(), NAME_None, RF_Transient);
+			DataTable->RowStruct = FScenario::StaticStruct();
+
+			const double StartTime = FPlatformTime::Seconds();
+			DataTable->CreateTableFromJSONString(JSON);
+			BestTime = FMath::Min(BestTime, FPlatformTime::Seconds() - StartTime);
+
+			TArray<FScenario*> Scenes;
+			DataTable->GetAllRows(UE_SOURCE_LOCATION, Scenes);
+			Test.TestEqual(TEXT("Number of imported scenes"), Scenes.Num(), NumScenes);
+			for (int32 i = 0; i < Scenes.Num(); i++)
+			{
+				if (Scenes[i]->GetOwner() != DataTable || Scenes[i]->GetIndex() != i)
+				{
+					Test.AddError(FString::Printf(TEXT("Scene %d of %d is not intruded: index %d."), i, NumScenes, Scenes[i]->GetIndex()));
+					break;
+				}
+			}
+
+			DataTable->MarkAsGarbage();
+		}
+
+		return BestTime;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVisualUScenarioImportScalingTest, "VisualU.Scenario.ImportScaling", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FVisualUScenarioImportScalingTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::VisualU::Tests::Private;
+
+	constexpr int32 NumScenes = 2000;
+	constexpr int32 NumRuns = 3;
+
+	/*Warm up allocators and the JSON parser*/
+	TimeImport(*this, NumScenes / 10, 1);
+
+	const double Time1N = TimeImport(*this, NumScenes, NumRuns);
+	const double Time2N = TimeImport(*this, NumScenes * 2, NumRuns);
+	const double Time4N = TimeImport(*this, NumScenes * 4, NumRuns);
+
+	AddInfo(FString::Printf(TEXT("Import of %d/%d/%d scenes: %.2f/%.2f/%.2f ms."), NumScenes, NumScenes * 2, NumScenes * 4, Time1N * 1000.0, Time2N * 1000.0, Time4N * 1000.0));
+
+	/*Linear import is 4 times slower on 4N rows, quadratic is 16 times slower*/
+	const double Ratio = Time4N / FMath::Max(Time1N, UE_DOUBLE_SMALL_NUMBER);
+	TestTrue(FString::Printf(TEXT("Import of 4N scenes scales near-linearly (%.2fx of N)"), Ratio), Ratio < 8.0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,160 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+
+#include "Misc/AutomationTest.h"
+#include "Engine/DataTable.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#include "UObject/UObjectHash.h"
+#include "VisualStoryPack.h"
+#include "VisualUTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+namespace UE::VisualU::Tests::Private
+{
+	/**
+	* Removes node and its package from memory, so that the next request reads it again.
+	*/
+	void UnloadNode(const FSoftObjectPath& Path)
+	{
+		if (UPackage* Package = FindPackage(nullptr, *Path.GetLongPackageName()))
+		{
+			ResetLoaders(Package);
+			ForEachObjectWithPackage(Package, [](UObject* Object)
+			{
+				Object->ClearFlags(RF_Public | RF_Standalone);
+				Object->MarkAsGarbage();
+				return true;
+			});
+			Package->MarkAsGarbage();
+		}
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	/**
+	* @return {@code true} when the node has the same scenes in the same order
+	*/
+	bool TestNode(FAutomationTestBase& Test, const TCHAR* What, const UDataTable* Node, const TArray<FName>& RowNames, const TArray<FScenario>& Scenes)
+	{
+		if (!Test.TestNotNull(What, Node))
+		{
+			return false;
+		}
+
+		TArray<FScenario*> Rows;
+		Node->GetAllRows(UE_SOURCE_LOCATION, Rows);
+		if (!Test.TestEqual(FString::Printf(TEXT("%s: number of scenes"), What), Rows.Num(), Scenes.Num()))
+		{
+			return false;
+		}
+
+		const TArray<FName> NodeRowNames = Node->GetRowNames();
+		for (int32 i = 0; i < Rows.Num(); i++)
+		{
+			if (NodeRowNames[i] != RowNames[i] || !AreScenesEqual(*Rows[i], Scenes[i]))
+			{
+				Test.AddError(FString::Printf(TEXT("%s: scene %s differs from the original."), What, *RowNames[i].ToString()));
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVisualUStoryPackLoadTest, "VisualU.StoryPack.Load", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FVisualUStoryPackLoadTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::VisualU::Tests;
+	using namespace UE::VisualU::Tests::Private;
+
+	constexpr int32 NumScenes = 2000;
+	const FString PackageName = TEXT("/Temp/VisualUTests/StoryPackNode");
+	const FString PackageFilename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+	const FString PackFilename = FPaths::AutomationTransientDir() / TEXT("VisualUTests.vspack");
+	const FSoftObjectPath Path(PackageName + TEXT(".StoryPackNode"));
+
+	TArray<FName> RowNames;
+	TArray<FScenario> Scenes;
+	{
+		UPackage* Package = CreatePackage(*PackageName);
+		UDataTable* Node = NewObject<UDataTable>(Package, TEXT("StoryPackNode"), RF_Public | RF_Standalone);
+		Node->RowStruct = FScenario::StaticStruct();
+
+		for (int32 i = 0; i < NumScenes; i++)
+		{
+			FScenario& Scene = Scenes.AddDefaulted_GetRef();
+			FillScene(Scene, i);
+			if (i % 10 == 9)
+			{
+				Scene.ChoiceTargets.Add(TSoftObjectPtr<UDataTable>(FSoftObjectPath(FString::Printf(TEXT("/Game/VisualUTests/Choice_%d.Choice_%d"), i, i))));
+			}
+
+			RowNames.Add(FName(TEXT("Scene"), i + 1));
+			Node->AddRow(RowNames.Last(), Scene);
+		}
+
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		SaveArgs.SaveFlags = SAVE_NoError;
+		if (!TestTrue(TEXT("Node package is saved"), UPackage::SavePackage(Package, Node, *PackageFilename, SaveArgs)))
+		{
+			return false;
+		}
+
+		TArray<uint8> PackData;
+		const UDataTable* Nodes[] = { Node };
+		TestEqual(TEXT("Number of packed nodes"), FVisualStoryPack::Write(Nodes, PackData), 1);
+		if (!TestTrue(TEXT("Story pack is written"), FFileHelper::SaveArrayToFile(PackData, *PackFilename)))
+		{
+			return false;
+		}
+	}
+
+	UnloadNode(Path);
+	TestNull(TEXT("Node is unloaded before loading its package"), Path.ResolveObject());
+
+	const double PackageStartTime = FPlatformTime::Seconds();
+	UDataTable* LoadedNode = Cast<UDataTable>(Path.TryLoad());
+	const double PackageTime = FPlatformTime::Seconds() - PackageStartTime;
+	TestNode(*this, TEXT("Node loaded from its package"), LoadedNode, RowNames, Scenes);
+	LoadedNode = nullptr;
+
+	UnloadNode(Path);
+	TestNull(TEXT("Node is unloaded before reading the story pack"), Path.ResolveObject());
+
+	/*FVisualStoryPack::LoadNode() does the same, but the pack of the settings is not used in the editor*/
+	const double PackStartTime = FPlatformTime::Seconds();
+	TUniquePtr<FVisualStoryPack> StoryPack = FVisualStoryPack::Open(PackFilename);
+	UDataTable* PackedNode = StoryPack.IsValid() ? StoryPack->FindOrCreateNode(Path) : nullptr;
+	const double PackTime = FPlatformTime::Seconds() - PackStartTime;
+	if (TestTrue(TEXT("Story pack is opened"), StoryPack.IsValid()))
+	{
+		TestTrue(TEXT("Story pack contains the node"), StoryPack->Contains(Path));
+		if (TestNode(*this, TEXT("Node created from the story pack"), PackedNode, RowNames, Scenes))
+		{
+			TArray<FScenario*> Rows;
+			PackedNode->GetAllRows(UE_SOURCE_LOCATION, Rows);
+			TestTrue(TEXT("Packed scenes know their node"), Rows.Last()->GetOwner() == PackedNode && Rows.Last()->GetIndex() == NumScenes - 1);
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("Node of %d scenes: %.2f ms from its package, %.2f ms from the story pack."), NumScenes, PackageTime * 1000.0, PackTime * 1000.0));
+
+	PackedNode = nullptr;
+	StoryPack.Reset();
+	UnloadNode(Path);
+	IFileManager::Get().Delete(*PackageFilename, /*RequireExists=*/false, /*EvenReadOnly=*/true, /*Quiet=*/true);
+	IFileManager::Get().Delete(*PackFilename, /*RequireExists=*/false, /*EvenReadOnly=*/true, /*Quiet=*/true);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,266 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+
+#include "Misc/AutomationTest.h"
+#include "Engine/DataTable.h"
+#include "Engine/Engine.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "PlatformFeatures.h"
+#include "SaveGameSystem.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "UObject/Package.h"
+#include "VisualController.h"
+#include "VisualUBlueprintStatics.h"
+#include "VisualVersioningSubsystem.h"
+#include "VisualUTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UE::VisualU::Tests::Private
+{
+	constexpr int32 NumNodeScenes = 3;
+
+	/**
+	* Nodes in memory and a world to own visual controllers.
+	* World does not begin play, so controllers are not initialized
+	* and receive their state from the loaded saves.
+	*/
+	struct FSaveTestFixture
+	{
+		FSaveTestFixture()
+			: World(UWorld::CreateWorld(EWorldType::Game, /*bInformEngineOfWorld=*/false)),
+			PlayerController(nullptr),
+			LocalPlayer(NewObject<ULocalPlayer>(GEngine, NAME_None, RF_Transient)),
+			Nodes()
+		{
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+			PlayerController = World->SpawnActor<APlayerController>();
+
+			for (const TCHAR* NodeName : { TEXT("SaveNodeA"), TEXT("SaveNodeB") })
+			{
+				UPackage* Package = CreatePackage(*(FString(TEXT("/Temp/VisualUTests/")) + NodeName));
+				UDataTable* Node = NewObject<UDataTable>(Package, NodeName, RF_Public | RF_Standalone | RF_Transient);
+				Node->RowStruct = FScenario::StaticStruct();
+				for (int32 i = 0; i < NumNodeScenes; i++)
+				{
+					FScenario Scene;
+					FillScene(Scene, Nodes.Num() * NumNodeScenes + i);
+					Node->AddRow(FName(TEXT("Scene"), i + 1), Scene);
+				}
+
+				/*Assigns owner and index to the scenes*/
+				Node->HandleDataTableChanged();
+				Nodes.Add(Node);
+			}
+		}
+
+		~FSaveTestFixture()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(/*bInformEngineOfWorld=*/false);
+			for (UDataTable* Node : Nodes)
+			{
+				Node->ClearFlags(RF_Public | RF_Standalone);
+				Node->MarkAsGarbage();
+			}
+
+			LocalPlayer->MarkAsGarbage();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+			ISaveGameSystem* SaveGameSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+			SaveGameSystem->DeleteGame(/*bAttemptToUseUI=*/false, *GetSaveFilename(), GetUserId());
+		}
+
+		UVisualController* CreateController() const
+		{
+			return NewObject<UVisualController>(PlayerController);
+		}
+
+		UVisualVersioningSubsystem* CreateSubsystem() const
+		{
+			return NewObject<UVisualVersioningSubsystem>(LocalPlayer);
+		}
+
+		FScenario* GetScene(int32 NodeIndex, int32 SceneIndex) const
+		{
+			return Nodes[NodeIndex]->FindRow<FScenario>(FName(TEXT("Scene"), SceneIndex + 1), UE_SOURCE_LOCATION);
+		}
+
+		static FString GetSaveFilename()
+		{
+			return TEXT("VisualUTests");
+		}
+
+		static FPlatformUserId GetUserId()
+		{
+			return FPlatformMisc::GetPlatformUserForUserIndex(0);
+		}
+
+		/**
+		* Save written before FVisualUCustomVersion::CompactSaveFormat: tagged properties and state of the subsystem,
+		* then of the controller, through FObjectAndNameAsStringProxyArchive and without a header.
+		* Second scene of the first node is versioned, controller is at the second scene of the second node.
+		*/
+		TArray<uint8> MakeLegacySave(UVisualVersioningSubsystem* Subsystem, UVisualController* Controller, TConstArrayView<FVisualScenarioInfo> Infos) const
+		{
+			TArray<uint8> Data;
+			FMemoryWriter Writer(Data);
+			FObjectAndNameAsStringProxyArchive ProxyAr(Writer, /*bInLoadIfFindFails=*/false);
+			ProxyAr.ArIsSaveGame = true;
+
+			Subsystem->UObject::Serialize(ProxyAr);
+			int32 NumVersionedScenes = 1;
+			ProxyAr << NumVersionedScenes;
+			ProxyAr << *GetScene(0, 1);
+			TArray<FVisualScenarioInfo> VersionedInfos(Infos);
+			ProxyAr << VersionedInfos;
+
+			Controller->UObject::Serialize(ProxyAr);
+			int32 NumExhaustedScenes = 1;
+			ProxyAr << NumExhaustedScenes;
+			ProxyAr << *GetScene(0, NumNodeScenes - 1);
+			ProxyAr << *GetScene(1, 1);
+			ProxyAr << *GetScene(1, 0);
+
+			return Data;
+		}
+
+		/**
+		* @return contents of the save file as written by the platform
+		*/
+		static TArray<uint8> ReadSaveFile()
+		{
+			TArray<uint8> Data;
+			ISaveGameSystem* SaveGameSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+			SaveGameSystem->LoadGame(/*bAttemptToUseUI=*/false, *GetSaveFilename(), GetUserId(), Data);
+
+			return Data;
+		}
+
+		static bool WriteSaveFile(const TArray<uint8>& Data)
+		{
+			ISaveGameSystem* SaveGameSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+			return SaveGameSystem->SaveGame(/*bAttemptToUseUI=*/false, *GetSaveFilename(), GetUserId(), Data);
+		}
+
+		UWorld* World;
+
+		APlayerController* PlayerController;
+
+		ULocalPlayer* LocalPlayer;
+
+		TArray<UDataTable*> Nodes;
+	};
+
+	/**
+	* @return {@code true} when the controller is at the second scene of the second node
+	*/
+	bool TestControllerState(FAutomationTestBase& Test, const TCHAR* What, const FSaveTestFixture& Fixture, const UVisualController* Controller)
+	{
+		if (!Test.TestTrue(FString::Printf(TEXT("%s: controller has a scene to save"), What), Controller->CanSave()))
+		{
+			return false;
+		}
+
+		const FScenario& CurrentScene = Controller->GetCurrentScenario();
+		return Test.TestTrue(FString::Printf(TEXT("%s: current scene is restored"), What), &CurrentScene == Fixture.GetScene(1, 1));
+	}
+
+	/**
+	* @return versions of the versioned scene, from the oldest to the current one
+	*/
+	TArray<FVisualScenarioInfo> MakeVersions(const FScenario& Scene)
+	{
+		TArray<FVisualScenarioInfo> Infos;
+		Infos.Add(Scene.Info);
+
+		FVisualScenarioInfo& Altered = Infos.Add_GetRef(Scene.Info);
+		Altered.Line = FText::AsCultureInvariant(TEXT("Altered line"));
+
+		FVisualScenarioInfo& Current = Infos.Add_GetRef(Altered);
+		Current.SpritesParams.Reset();
+		Current.Flags = 0;
+
+		return Infos;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVisualUSaveRoundTripTest, "VisualU.Save.RoundTrip", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVisualUSaveRoundTripTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::VisualU::Tests;
+	using namespace UE::VisualU::Tests::Private;
+
+	FSaveTestFixture Fixture;
+	FScenario& VersionedScene = *Fixture.GetScene(0, 1);
+	const TArray<FVisualScenarioInfo> Infos = MakeVersions(VersionedScene);
+
+	/*Legacy save is the only way to give state to a controller that is not initialized*/
+	UVisualVersioningSubsystem* Subsystem = Fixture.CreateSubsystem();
+	UVisualController* Controller = Fixture.CreateController();
+	if (!TestTrue(TEXT("Legacy save is written"), Fixture.WriteSaveFile(Fixture.MakeLegacySave(Subsystem, Controller, Infos)))
+		|| !TestTrue(TEXT("Legacy save is loaded"), UVisualUBlueprintStatics::LoadVisualU(Subsystem, Controller, 0, Fixture.GetSaveFilename()))
+		|| !TestControllerState(*this, TEXT("Legacy save"), Fixture, Controller))
+	{
+		Subsystem->Deinitialize();
+		return false;
+	}
+
+	TestTrue(TEXT("Save is written"), UVisualUBlueprintStatics::SaveVisualU(Subsystem, Controller, 0, Fixture.GetSaveFilename()));
+	const TArray<uint8> SaveData = Fixture.ReadSaveFile();
+	Subsystem->Deinitialize();
+	TestTrue(TEXT("Versioned scene is reset by the subsystem"), AreInfosEqual(VersionedScene.Info, Infos[0]));
+
+	UVisualVersioningSubsystem* LoadedSubsystem = Fixture.CreateSubsystem();
+	UVisualController* LoadedController = Fixture.CreateController();
+	TestTrue(TEXT("Save is loaded"), UVisualUBlueprintStatics::LoadVisualU(LoadedSubsystem, LoadedController, 0, Fixture.GetSaveFilename()));
+	TestControllerState(*this, TEXT("Save"), Fixture, LoadedController);
+	TestTrue(TEXT("Versioned scene has its current information"), AreInfosEqual(VersionedScene.Info, Infos.Last()));
+
+	/*Loaded state must be written exactly as it was read*/
+	TestTrue(TEXT("Loaded save is written again"), UVisualUBlueprintStatics::SaveVisualU(LoadedSubsystem, LoadedController, 0, Fixture.GetSaveFilename()));
+	TestTrue(TEXT("Second save is identical to the first one"), Fixture.ReadSaveFile() == SaveData);
+
+	LoadedSubsystem->Deinitialize();
+	TestTrue(TEXT("Versioned scene is reset by the loaded subsystem"), AreInfosEqual(VersionedScene.Info, Infos[0]));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVisualUSaveLegacyTest, "VisualU.Save.Legacy", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVisualUSaveLegacyTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::VisualU::Tests;
+	using namespace UE::VisualU::Tests::Private;
+
+	FSaveTestFixture Fixture;
+	FScenario& VersionedScene = *Fixture.GetScene(0, 1);
+	const TArray<FVisualScenarioInfo> Infos = MakeVersions(VersionedScene);
+
+	UVisualVersioningSubsystem* Subsystem = Fixture.CreateSubsystem();
+	UVisualController* Controller = Fixture.CreateController();
+	const TArray<uint8> LegacyData = Fixture.MakeLegacySave(Subsystem, Controller, Infos);
+	if (!TestTrue(TEXT("Legacy save is written"), Fixture.WriteSaveFile(LegacyData)))
+	{
+		return false;
+	}
+
+	/*Legacy saves start with tagged properties, never with the magic of the current format*/
+	TestTrue(TEXT("Legacy save is read through the fallback"), LegacyData.Num() >= 4 && FMemory::Memcmp(LegacyData.GetData(), "VISU", 4) != 0);
+	TestTrue(TEXT("Legacy save is loaded"), UVisualUBlueprintStatics::LoadVisualU(Subsystem, Controller, 0, Fixture.GetSaveFilename()));
+	TestControllerState(*this, TEXT("Legacy save"), Fixture, Controller);
+	TestTrue(TEXT("Versioned scene has its current information"), AreInfosEqual(VersionedScene.Info, Infos.Last()));
+
+	Subsystem->Deinitialize();
+	TestTrue(TEXT("Versions of the legacy save reset the scene"), AreInfosEqual(VersionedScene.Info, Infos[0]));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,72 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Scenario.h"
+#include "VisualImage.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UE::VisualU::Tests
+{
+	/**
+	* Fills scene with data that depends on its position,
+	* so that scenes of a node are all different.
+	*
+	* @param Scene scene to fill
+	* @param SceneIndex position of the scene
+	*/
+	inline void FillScene(FScenario& Scene, int32 SceneIndex)
+	{
+		FVisualScenarioInfo& Info = Scene.Info;
+		Info.Author = FText::AsLocalizable_Advanced(TEXT("VisualUTests"), FString::Printf(TEXT("Author_%d"), SceneIndex % 3), FString::Printf(TEXT("Author %d"), SceneIndex % 3));
+		Info.Line = FText::AsCultureInvariant(FString::Printf(TEXT("Line <b>%d</> of the test node."), SceneIndex));
+		Info.Sound = TSoftObjectPtr<USoundBase>(FSoftObjectPath(FString::Printf(TEXT("/Game/VisualUTests/Sound_%d.Sound_%d"), SceneIndex % 5, SceneIndex % 5)));
+		Info.Background.BackgroundArtInfo.Expression = TSoftObjectPtr<UPaperFlipbook>(FSoftObjectPath(FString::Printf(TEXT("/Game/VisualUTests/Background_%d.Background_%d"), SceneIndex % 7, SceneIndex % 7)));
+		Info.Background.BackgroundArtInfo.FrameIndex = SceneIndex % 4;
+		Info.Flags = StaticCast<uint8>(SceneIndex % 4);
+
+		Info.SpritesParams.SetNum(SceneIndex % 3);
+		for (int32 i = 0; i < Info.SpritesParams.Num(); i++)
+		{
+			FSprite& Sprite = Info.SpritesParams[i];
+			Sprite.SpriteClass = TSoftClassPtr<UVisualSprite>(FSoftObjectPath(FString::Printf(TEXT("/Game/VisualUTests/Sprite_%d.Sprite_%d_C"), i, i)));
+			Sprite.Anchors = FAnchors(0.25f * i, 0.5f);
+			Sprite.Position = FVector2D(SceneIndex, -i);
+			Sprite.ZOrder = i;
+
+			FVisualImageInfo& ImageInfo = Sprite.SpriteInfo.AddDefaulted_GetRef();
+			ImageInfo.Expression = TSoftObjectPtr<UPaperFlipbook>(FSoftObjectPath(FString::Printf(TEXT("/Game/VisualUTests/Expression_%d.Expression_%d"), SceneIndex % 2, SceneIndex % 2)));
+			ImageInfo.ColorAndOpacity = FLinearColor(1.f, 0.5f, 0.25f, 1.f);
+			ImageInfo.MirrorScale = FVector2D(i % 2 ? -1 : 1, 1);
+			ImageInfo.bAnimate = (SceneIndex + i) % 2 == 0;
+		}
+	}
+
+	/**
+	* Texts are compared by their display strings,
+	* since their history is not preserved by every format.
+	*
+	* @return {@code true} when all members of the infos are equal
+	*/
+	inline bool AreInfosEqual(const FVisualScenarioInfo& A, const FVisualScenarioInfo& B)
+	{
+		return A.Author.ToString().Equals(B.Author.ToString(), ESearchCase::CaseSensitive)
+			&& A.Line.ToString().Equals(B.Line.ToString(), ESearchCase::CaseSensitive)
+			&& A.Sound == B.Sound
+			&& A.Background == B.Background
+			&& A.SpritesParams == B.SpritesParams
+			&& A.Flags == B.Flags;
+	}
+
+	/**
+	* @return {@code true} when data of the scenes is equal, regardless of their nodes
+	*/
+	inline bool AreScenesEqual(const FScenario& A, const FScenario& B)
+	{
+		return AreInfosEqual(A.Info, B.Info) && A.ChoiceTargets == B.ChoiceTargets;
+	}
+}
+
+#endif
@@ -0,0 +1,218 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+
+#include "Misc/AutomationTest.h"
+#include "Engine/DataTable.h"
+#include "Engine/Engine.h"
+#include "Engine/LocalPlayer.h"
+#include "Serialization/CustomVersion.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "UObject/Package.h"
+#include "ScenarioInfoPatch.h"
+#include "VisualUCustomVersion.h"
+#include "VisualVersioningSubsystem.h"
+#include "VisualUTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UE::VisualU::Tests::Private
+{
+	/**
+	* Successive versions of the scene information, starting with the original.
+	* Every version changes different members, the last one changes all of them.
+	*/
+	TArray<FVisualScenarioInfo> MakeVersionChain(const FVisualScenarioInfo& Original)
+	{
+		FScenario Other;
+		FillScene(Other, 4);
+
+		TArray<FVisualScenarioInfo> Infos;
+		Infos.Add(Original);
+
+		FVisualScenarioInfo& LineChanged = Infos.Add_GetRef(Infos.Last());
+		LineChanged.Line = FText::AsCultureInvariant(TEXT("Altered line"));
+
+		FVisualScenarioInfo& SpritesChanged = Infos.Add_GetRef(Infos.Last());
+		SpritesChanged.SpritesParams = Other.Info.SpritesParams;
+		SpritesChanged.Flags = Other.Info.Flags;
+
+		FVisualScenarioInfo& BackgroundChanged = Infos.Add_GetRef(Infos.Last());
+		BackgroundChanged.Background = Other.Info.Background;
+		BackgroundChanged.Sound = Other.Info.Sound;
+
+		FVisualScenarioInfo& AllChanged = Infos.Add_GetRef(Other.Info);
+		AllChanged.Author = FText::AsCultureInvariant(TEXT("Altered author"));
+
+		return Infos;
+	}
+
+	/**
+	* Node in memory with a versioning subsystem.
+	*/
+	struct FVersioningTestFixture
+	{
+		FVersioningTestFixture()
+			: LocalPlayer(NewObject<ULocalPlayer>(GEngine, NAME_None, RF_Transient)),
+			Subsystem(nullptr),
+			Node(nullptr)
+		{
+			Subsystem = NewObject<UVisualVersioningSubsystem>(LocalPlayer);
+
+			UPackage* Package = CreatePackage(TEXT("/Temp/VisualUTests/VersioningNode"));
+			Node = NewObject<UDataTable>(Package, TEXT("VersioningNode"), RF_Public | RF_Standalone | RF_Transient);
+			Node->RowStruct = FScenario::StaticStruct();
+			for (int32 i = 0; i < 3; i++)
+			{
+				FScenario Scene;
+				FillScene(Scene, i);
+				Node->AddRow(FName(TEXT("Scene"), i + 1), Scene);
+			}
+
+			/*Assigns owner and index to the scenes*/
+			Node->HandleDataTableChanged();
+		}
+
+		~FVersioningTestFixture()
+		{
+			Subsystem->Deinitialize();
+			Node->ClearFlags(RF_Public | RF_Standalone);
+			Node->MarkAsGarbage();
+			LocalPlayer->MarkAsGarbage();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		}
+
+		FScenario& GetScene(int32 SceneIndex) const
+		{
+			return *Node->FindRow<FScenario>(FName(TEXT("Scene"), SceneIndex + 1), UE_SOURCE_LOCATION);
+		}
+
+		ULocalPlayer* LocalPlayer;
+
+		UVisualVersioningSubsystem* Subsystem;
+
+		UDataTable* Node;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVisualUScenarioInfoPatchTest, "VisualU.Versioning.Patch", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVisualUScenarioInfoPatchTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::VisualU::Tests;
+	using namespace UE::VisualU::Tests::Private;
+
+	FScenario Scene;
+	FillScene(Scene, 1);
+	const TArray<FVisualScenarioInfo> Infos = MakeVersionChain(Scene.Info);
+
+	TestTrue(TEXT("Patch of identical infos stores nothing"), FScenarioInfoPatch::Diff(Infos[0], Infos[0]).GetStoredMembers() == EScenarioInfoMembers::None);
+	TestTrue(TEXT("Patch stores only changed members"), FScenarioInfoPatch::Diff(Infos[1], Infos[2]).GetStoredMembers() == (EScenarioInfoMembers::SpritesParams | EScenarioInfoMembers::Flags));
+	TestTrue(TEXT("Patch of the info with all members changed stores all of them"), FScenarioInfoPatch::Diff(Infos[0], Infos.Last()).GetStoredMembers() == EScenarioInfoMembers::All);
+
+	for (int32 i = 0; i + 1 < Infos.Num(); i++)
+	{
+		const FScenarioInfoPatch Patch = FScenarioInfoPatch::Diff(Infos[i], Infos[i + 1]);
+
+		FVisualScenarioInfo Info = Infos[i + 1];
+		Patch.Apply(Info);
+		TestTrue(FString::Printf(TEXT("Patch %d restores the previous version"), i), AreInfosEqual(Info, Infos[i]));
+
+		TArray<uint8> Data;
+		FMemoryWriter Writer(Data);
+		FObjectAndNameAsStringProxyArchive WriterProxy(Writer, /*bInLoadIfFindFails=*/false);
+		FScenarioInfoPatch SavedPatch = Patch;
+		WriterProxy << SavedPatch;
+
+		FMemoryReader Reader(Data);
+		FObjectAndNameAsStringProxyArchive ReaderProxy(Reader, /*bInLoadIfFindFails=*/false);
+		FScenarioInfoPatch LoadedPatch;
+		ReaderProxy << LoadedPatch;
+		TestTrue(FString::Printf(TEXT("Patch %d keeps its members when serialized"), i), LoadedPatch.GetStoredMembers() == Patch.GetStoredMembers());
+
+		Info = Infos[i + 1];
+		LoadedPatch.Apply(Info);
+		TestTrue(FString::Printf(TEXT("Serialized patch %d restores the previous version"), i), AreInfosEqual(Info, Infos[i]));
+	}
+
+	FVersioningTestFixture Fixture;
+	FScenario& VersionedScene = Fixture.GetScene(1);
+	const TArray<FVisualScenarioInfo> SceneInfos = MakeVersionChain(VersionedScene.Info);
+	for (int32 i = 1; i < SceneInfos.Num(); i++)
+	{
+		Fixture.Subsystem->AlterDataTable(Fixture.Node, FName(TEXT("Scene"), 2), SceneInfos[i]);
+		TestTrue(FString::Printf(TEXT("Version %d is applied to the scene"), i), AreInfosEqual(VersionedScene.Info, SceneInfos[i]));
+	}
+
+	Fixture.Subsystem->Deinitialize();
+	TestTrue(TEXT("Patches of all versions restore the original scene"), AreInfosEqual(VersionedScene.Info, SceneInfos[0]));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVisualUScenarioInfoMigrationTest, "VisualU.Versioning.Migration", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVisualUScenarioInfoMigrationTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::VisualU::Tests;
+	using namespace UE::VisualU::Tests::Private;
+
+	FVersioningTestFixture Fixture;
+	FScenario& VersionedScene = Fixture.GetScene(2);
+	const TArray<FVisualScenarioInfo> Infos = MakeVersionChain(VersionedScene.Info);
+
+	/*Versions written before FVisualUCustomVersion::ScenarioInfoPatches: full copies followed by the current information*/
+	TArray<uint8> Data;
+	{
+		FMemoryWriter Writer(Data);
+		FObjectAndNameAsStringProxyArchive WriterProxy(Writer, /*bInLoadIfFindFails=*/false);
+		WriterProxy.ArIsSaveGame = true;
+		Fixture.Subsystem->UObject::Serialize(WriterProxy);
+
+		bool bIsJournal = false;
+		int32 NumVersionedScenes = 1;
+		TArray<FVisualScenarioInfo> FullCopies(Infos);
+		WriterProxy << bIsJournal;
+		WriterProxy << NumVersionedScenes;
+		WriterProxy << VersionedScene;
+		WriterProxy << FullCopies;
+	}
+
+	FMemoryReader Reader(Data);
+	Reader.SetCustomVersion(FVisualUCustomVersion::GUID, FVisualUCustomVersion::VersioningJournal, TEXT("VisualUVersion"));
+	FObjectAndNameAsStringProxyArchive ReaderProxy(Reader, /*bInLoadIfFindFails=*/false);
+	Fixture.Subsystem->SerializeSubsystem(ReaderProxy);
+	if (!TestFalse(TEXT("Full copies are read"), ReaderProxy.IsError() || Reader.Tell() != Data.Num()))
+	{
+		return false;
+	}
+
+	TestTrue(TEXT("Scene has its current information"), AreInfosEqual(VersionedScene.Info, Infos.Last()));
+
+	/*Migrated patches are saved in the current format and read back*/
+	TArray<uint8> MigratedData;
+	FCustomVersionContainer MigratedVersions;
+	{
+		FMemoryWriter Writer(MigratedData);
+		FObjectAndNameAsStringProxyArchive WriterProxy(Writer, /*bInLoadIfFindFails=*/false);
+		Fixture.Subsystem->SerializeSubsystem(WriterProxy);
+		MigratedVersions = WriterProxy.GetCustomVersions();
+	}
+
+	Fixture.Subsystem->Deinitialize();
+	TestTrue(TEXT("Migrated versions restore the original scene"), AreInfosEqual(VersionedScene.Info, Infos[0]));
+
+	FMemoryReader MigratedReader(MigratedData);
+	MigratedReader.SetCustomVersions(MigratedVersions);
+	FObjectAndNameAsStringProxyArchive MigratedReaderProxy(MigratedReader, /*bInLoadIfFindFails=*/false);
+	Fixture.Subsystem->SerializeSubsystem(MigratedReaderProxy);
+	TestTrue(TEXT("Migrated versions are loaded with the current information"), AreInfosEqual(VersionedScene.Info, Infos.Last()));
+
+	Fixture.Subsystem->Deinitialize();
+	TestTrue(TEXT("Loaded migrated versions restore the original scene"), AreInfosEqual(VersionedScene.Info, Infos[0]));
+
+	return true;
+}
+
+#endif
@@ -10,17 +10,59 @@
 #include "Engine/World.h"
 #include "Misc/App.h"
 #include "Tasks/Task.h"
-#include "Containers/Queue.h"
+#include "Algo/AllOf.h"
 #include "GameFramework/PlayerController.h"
 #include "GameFramework/GameModeBase.h"
 #include "Components/WidgetComponent.h"
 #include "Sound/SoundBase.h"
 #include "VisualVersioningSubsystem.h"
 #include "VisualUCustomVersion.h"
+#include "ScenarioNodeCache.h"
+#include "VisualStoryPack.h"
 #include "VisualUSettings.h"
 #include "VisualRenderer.h"
+#include "VisualTextBlock.h"
 #include "VisualU.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pending Scene Requests"), STAT_PendingSceneRequests, STATGROUP_VisualU);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Scenes To Load"), STAT_ScenesToLoad, STATGROUP_VisualU);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Prefetch Hit Rate"), STAT_PrefetchHitRate, STATGROUP_VisualU);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Average Scene Load Time (ms)"), STAT_AverageSceneLoadTime, STATGROUP_VisualU);
+DECLARE_CYCLE_STAT(TEXT("Controller Initialization"), STAT_ControllerInitialization, STATGROUP_VisualU);
+
+namespace UE::VisualU::Private
+{
+	/*Weight of the newest sample in moving averages of the adaptive prefetch*/
+	constexpr double PrefetchSmoothing = 0.2;
+
+	/*Pauses longer than this, in seconds, are not accounted as reading time*/
+	constexpr double MaxAdvanceInterval = 60.0;
+
+	/*Number of characters the player reads, rich text tags are skipped*/
+	int32 GetReadableLength(const FString& Line)
+	{
+		int32 Length = 0;
+		bool bIsInTag = false;
+		for (const TCHAR Character : Line)
+		{
+			if (Character == TEXT('<'))
+			{
+				bIsInTag = true;
+			}
+			else if (Character == TEXT('>') && bIsInTag)
+			{
+				bIsInTag = false;
+			}
+			else if (!bIsInTag)
+			{
+				Length++;
+			}
+		}
+
+		return Length;
+	}
+}
+
 void UE::VisualU::Private::FFastMoveAsyncWorker::DoWork()
 {
 	checkf(VisualController, TEXT("Can't start fast move for invalid controller."));
@@ -29,6 +71,11 @@ void UE::VisualU::Private::FFastMoveAsyncWorker::DoWork()
 	{
 		if (IsValid(VisualController) && VisualController->IsFastMoving())
 		{
+			if (VisualController->IsScenePending())
+			{
+				return true;
+			}
+
 			const bool bCanContinue = (ControllerDirection == EVisualControllerDirection::Forward
 				? (!VisualController->IsCurrentScenarioHead() 
 					&& !VisualController->IsWithChoice() 
@@ -53,26 +100,63 @@ UVisualController::UVisualController(const FObjectInitializer& ObjectInitializer
 	: Super(ObjectInitializer),
 	Renderer(nullptr),
 	NextSceneHandle(nullptr),
+	PendingSceneHandle(nullptr),
+	PreDrawHandle(nullptr),
+	InitializationHandle(nullptr),
+	SavedScenes(),
+	ChoiceTargetsHandle(nullptr),
+	ChoiceSceneHandles(),
+	PreparedChoice(nullptr),
 	Node(),
 	SceneIndex(0),
-	SceneHandles(),
+	AssetPins(),
+	SceneResidency(AssetPins, 512ll * 1024 * 1024),
 	NodeReferenceKeeper(),
 	ExhaustedScenes(),
+	ExhaustedNodePositions(),
 	Head(nullptr),
 	FastMoveTask(nullptr),
+	FastMoveHandle(),
 	AutoMoveHandle(),
+	AutoMoveDirection(EVisualControllerDirection::None),
+	bIsSceneRead(false),
+	AutoMoveTextBlock(nullptr),
 	ScenesToLoad(5),
+	SceneMemoryBudget(512),
+	ChoiceScenesToLoad(2),
+	bSkipIntermediateScenes(false),
+	SkipFeedbackInterval(0),
+	bSynchronousAdvance(false),
+	bInitializeAsynchronously(false),
+	bLoadAsynchronously(false),
+	bIsReady(false),
+	InitializationProgress(0.f),
+	InitializationStartTime(0.0),
+	bAdaptiveScenesToLoad(false),
+	MinScenesToLoad(2),
+	MaxScenesToLoad(20),
+	AverageSceneLoadTime(0.0),
+	AverageAdvanceInterval(0.0),
+	LastAdvanceTime(0.0),
+	PrefetchHits(0),
+	PrefetchMisses(0),
 	bPlayTransitions(true),
 	bPlaySound(true),
 	AutoMoveDelay(5.f),
+	AutoMovePacing(EVisualAutoMovePacing::Fixed),
+	AutoMoveTimePerCharacter(0.05f),
 	Mode(EVisualControllerMode::Idle)
 {
 }
 
 void UVisualController::BeginDestroy()
 {
+	CancelInitialization();
 	CancelFastMove();
 	CancelAutoMove();
+	CancelPendingScene();
+	CancelChoiceScenes();
+	SceneResidency.Empty();
 
 	if (Renderer)
 	{
@@ -87,6 +171,7 @@ void UVisualController::PreSave(FObjectPreSaveContext SaveContext)
 {
 	CancelFastMove();
 	CancelAutoMove();
+	CancelPendingScene();
 
 	if (Renderer)
 	{
@@ -106,34 +191,9 @@ void UVisualController::PostInitProperties()
 	{
 		auto Initialization = [this](APlayerController* PlayerController)
 		{
-			APlayerController* OwningPlayerController = GetOuterAPlayerController();
-			if (OwningPlayerController == PlayerController)
+			if (GetOuterAPlayerController() == PlayerController)
 			{
-				const UVisualUSettings* VisualUSettings = GetDefault<UVisualUSettings>();
-				check(VisualUSettings);
-
-				checkf(!VisualUSettings->FirstDataTable.IsNull(), TEXT("Unable to find first data table, please specify one in project settings."));
-				const UDataTable* FirstDataTable = VisualUSettings->FirstDataTable.LoadSynchronous();
-
-				checkf(FirstDataTable->GetRowStruct()->IsChildOf(FScenario::StaticStruct()), TEXT("Data table must be based on FScenario struct."));
-				FirstDataTable->GetAllRows(UE_SOURCE_LOCATION, Node);
-
-				checkf(Node.IsValidIndex(0), TEXT("First Data Table is empty!"));
-				Head = GetCurrentScene();
-				NodeReferenceKeeper.Add(FirstDataTable);
-
-				OnSceneStart.Broadcast(*Head);
-
-				Renderer = CreateWidget<UVisualRenderer>(OwningPlayerController, UVisualRenderer::StaticClass());
-				check(Renderer);
-
-				/*Rebuild widget immediately to create renderer widgets*/
-				Renderer->TakeWidget();
-
-				TSharedPtr<FStreamableHandle> HeadHandle = LoadScene(Head);
-				Renderer->DrawScene(Head);
-				TryPlaySceneSound(Head->Info.Sound);
-				PrepareScenes();
+				Initialize();
 			}
 		};
 
@@ -162,6 +222,27 @@ void UVisualController::SerializeController(FArchive& Ar)
 
 	if (Ar.IsSaving())
 	{
+		/*Save requests are refused until the first scene is known*/
+		if (!CanSave())
+		{
+			return;
+		}
+
+		/*Loaded state is not applied until its nodes are loaded, so it is written back as it was read*/
+		if (SavedScenes.Num() >= 2)
+		{
+			int32 NumExhaustedScenes = SavedScenes.Num() - 2;
+			Ar << NumExhaustedScenes;
+			for (FSavedScene& SavedScene : SavedScenes)
+			{
+				TSoftObjectPtr<UDataTable> SoftOwner = TSoftObjectPtr<UDataTable>(SavedScene.Owner);
+				Ar << SoftOwner;
+				Ar << SavedScene.Index;
+			}
+
+			return;
+		}
+
 		int32 NumExhaustedScenes = ExhaustedScenes.Num();
 		Ar << NumExhaustedScenes;
 		for (FScenario*& ExhaustedScene : ExhaustedScenes)
@@ -174,38 +255,30 @@ void UVisualController::SerializeController(FArchive& Ar)
 	}
 	else
 	{
+		CancelInitialization();
+		CancelPendingScene();
+
 		int32 NumExhaustedScenes = 0;
 		Ar << NumExhaustedScenes;
-		ExhaustedScenes.Reserve(NumExhaustedScenes);
-		for (int32 i = 0; i < NumExhaustedScenes; i++)
+
+		/*Same layout as FScenario, but nodes are not loaded*/
+		SavedScenes.Reset(NumExhaustedScenes + 2);
+		for (int32 i = 0; i < NumExhaustedScenes + 2; i++)
 		{
-			FScenario ExhaustedScene;
-			Ar << ExhaustedScene;
-			ExhaustedScenes.Add(FScenario::ResolveScene(ExhaustedScene));
+			TSoftObjectPtr<UDataTable> SoftOwner;
+			FSavedScene& SavedScene = SavedScenes.AddDefaulted_GetRef();
+			Ar << SoftOwner;
+			Ar << SavedScene.Index;
+			SavedScene.Owner = SoftOwner.ToSoftObjectPath();
 		}
 
-		FScenario CurrentScenario;
-		Ar << CurrentScenario;
-		if (CurrentScenario.GetOwner())
+		if (bLoadAsynchronously)
 		{
-			Node.Empty();
-			CurrentScenario.GetOwner()->GetAllRows(UE_SOURCE_LOCATION, Node);
+			LoadSavedScenesAsync();
 		}
-		SceneIndex = CurrentScenario.GetIndex();
-
-		FScenario SavedHead;
-		Ar << SavedHead;
-		Head = FScenario::ResolveScene(SavedHead);
-
-		if (UWorld* World = GetWorld(); World && World->GetBegunPlay())
+		else
 		{
-			const FScenario* CurrentScene = GetCurrentScene();
-			TSharedPtr<FStreamableHandle> CurrentSceneHandle = LoadScene(CurrentScene);
-			Renderer->DrawScene(CurrentScene);
-			TryPlaySceneSound(CurrentScene->Info.Sound);
-			PrepareScenes();
-
-			OnSceneStart.Broadcast(*CurrentScene);
+			FinishLoadingSavedScenes(bIsReady);
 		}
 	}
 }
@@ -221,41 +294,33 @@ void UVisualController::Serialize(FArchive& Ar)
 bool UVisualController::RequestNextScene()
 {
 	check(Renderer);
-	if (!CanAdvanceScene() || IsTransitioning())
+	/*Stepped skip owns the scene index until it reaches its target*/
+	if (!IsReady() || !CanAdvanceScene() || IsTransitioning() || IsScenePending() || FastMoveHandle.IsValid())
 	{
 		return false;
 	}
 
-	OnSceneEnd.Broadcast(GetCurrentScenario());
-
 	PrepareScenes();
-	AssertNextSceneLoad();
 
-	SceneIndex += 1;
+	TrackPrefetch(EVisualControllerDirection::Forward);
 
-	const FScenario* CurrentScene = GetCurrentScene();
-	if (SceneIndex > Head->GetIndex() && Head->GetOwner() == CurrentScene->GetOwner())
+	if (bSynchronousAdvance)
 	{
-		Head = CurrentScene;
+		AssertNextSceneLoad();
+		ShowAdjacentScene(EVisualControllerDirection::Forward);
 	}
-
-	if (!TryPlayTransition(GetSceneAt(SceneIndex - 1), CurrentScene))
+	else
 	{
-		Renderer->DrawScene(CurrentScene);
+		AwaitNextSceneLoad();
 	}
 
-	TryPlaySceneSound(CurrentScene->Info.Sound);
-	CancelNextScene();
-
-	OnSceneStart.Broadcast(*CurrentScene);
-
 	return true;
 }
 
 bool UVisualController::RequestPreviousScene()
 {
 	check(Renderer);
-	if (IsTransitioning())
+	if (!IsReady() || IsTransitioning() || IsScenePending() || FastMoveHandle.IsValid())
 	{
 		return false;
 	}
@@ -269,6 +334,7 @@ bool UVisualController::RequestPreviousScene()
 				VisualVersioning->Checkout(const_cast<FScenario*>(GetCurrentScene()));
 			}
 			FScenario* Scene = ExhaustedScenes.Pop();
+			ExhaustedNodePositions.Remove(Scene->GetOwner());
 			RollbackTo(Scene);
 			return true;
 		}
@@ -276,24 +342,19 @@ bool UVisualController::RequestPreviousScene()
 		return false;
 	}
 
-	if (UVisualVersioningSubsystem* VisualVersioning = TryGetVisualVersioningSubsystem())
-	{
-		VisualVersioning->Checkout(const_cast<FScenario*>(GetCurrentScene()));
-	}
-
-	OnSceneEnd.Broadcast(GetCurrentScenario());
-
 	PrepareScenes(EVisualControllerDirection::Backward);
-	AssertNextSceneLoad(EVisualControllerDirection::Backward);
 
-	SceneIndex -= 1;
+	TrackPrefetch(EVisualControllerDirection::Backward);
 
-	const FScenario* CurrentScene = GetCurrentScene();
-	Renderer->DrawScene(CurrentScene);
-
-	CancelNextScene();
-
-	OnSceneStart.Broadcast(*CurrentScene);
+	if (bSynchronousAdvance)
+	{
+		AssertNextSceneLoad(EVisualControllerDirection::Backward);
+		ShowAdjacentScene(EVisualControllerDirection::Backward);
+	}
+	else
+	{
+		AwaitNextSceneLoad(EVisualControllerDirection::Backward);
+	}
 
 	return true;
 }
@@ -311,7 +372,7 @@ bool UVisualController::RequestAdjacentScene(EVisualControllerDirection::Type Di
 
 bool UVisualController::RequestScene(const FScenario* Scene)
 {
-	if (IsTransitioning())
+	if (!IsReady() || IsTransitioning())
 	{
 		return false;
 	}
@@ -320,33 +381,33 @@ bool UVisualController::RequestScene(const FScenario* Scene)
 	bool bIsFound = false;
 	if (ensureMsgf(!(Scene->GetOwner() == Head->GetOwner() && Scene->GetIndex() > Head->GetIndex()), TEXT("Only \"seen\" scene can be requested - %s"), *Scene->GetDebugString()))
 	{
-		if (Node[0]->GetOwner() == Scene->GetOwner())
+		if (GetCurrentScene()->GetOwner() == Scene->GetOwner())
 		{
 			bIsFound = true;
 		}
-		else
+		else if (const int32* Position = ExhaustedNodePositions.Find(Scene->GetOwner()))
 		{
-			UVisualVersioningSubsystem* VisualVersioning = TryGetVisualVersioningSubsystem();
-			/*Traverse the stack until the requested Node is found*/
-			for (int32 i = ExhaustedScenes.Num() - 1; i >= 0; i--)
+			const int32 NodePosition = *Position;
+			/*Release nodes above the requested one, requested node is retained*/
+			TArray<const UDataTable*, TInlineAllocator<16>> ReleasedNodes;
+			ReleasedNodes.Reserve(ExhaustedScenes.Num() - NodePosition);
+			for (int32 i = ExhaustedScenes.Num() - 1; i >= NodePosition; i--)
 			{
-				if (ExhaustedScenes[i]->GetOwner() == Scene->GetOwner())
+				const UDataTable* ExhaustedNode = ExhaustedScenes[i]->GetOwner();
+				ReleasedNodes.Add(ExhaustedNode);
+				ExhaustedNodePositions.Remove(ExhaustedNode);
+				if (i != NodePosition)
 				{
-					FScenario* ExhaustedScene = ExhaustedScenes.Pop();
-					if (VisualVersioning)
-					{
-						VisualVersioning->CheckoutAll(ExhaustedScene->GetOwner());
-					}
-					bIsFound = true;
-					break;
-				}
-				FScenario* ExhaustedScene = ExhaustedScenes.Pop();
-				NodeReferenceKeeper.Remove(ExhaustedScene->GetOwner());
-				if (VisualVersioning)
-				{
-					VisualVersioning->CheckoutAll(ExhaustedScene->GetOwner());
+					NodeReferenceKeeper.Remove(ExhaustedNode);
 				}
 			}
+			ExhaustedScenes.SetNum(NodePosition, EAllowShrinking::No);
+
+			if (UVisualVersioningSubsystem* VisualVersioning = TryGetVisualVersioningSubsystem())
+			{
+				VisualVersioning->CheckoutAll(ReleasedNodes);
+			}
+			bIsFound = true;
 		}
 
 		if (bIsFound)
@@ -365,39 +426,37 @@ bool UVisualController::RequestScenario(const FScenario& Scenario)
 
 const FScenario* UVisualController::GetSceneAt(int32 Index)
 {
-	check(Node.IsValidIndex(Index));
-	return Node[Index];
+	check(Node.IsValid() && Node->IsValidIndex(Index));
+	return (*Node)[Index];
 }
 
 bool UVisualController::RequestNode(const UDataTable* NewNode)
 {
-	if (IsTransitioning() || !IsIdle())
+	if (!IsReady() || IsTransitioning() || !IsIdle())
 	{
 		return false;
 	}
 	check(Renderer);
 	check(NewNode);
+	CancelPendingScene();
 	checkf(!NewNode->GetRowMap().IsEmpty(), TEXT("Requesting empty node is not allowed."));
 	checkf(GetCurrentScene()->GetOwner() != NewNode, TEXT("Requesting active node is not allowed."));
 	checkf(NewNode->GetRowStruct()->IsChildOf(FScenario::StaticStruct()), TEXT("Node must be based on FScenario struct."));
 #if !UE_BUILD_SHIPPING
-	for (const FScenario* ExhaustedScene : ExhaustedScenes)
-	{
-		checkf(ExhaustedScene->GetOwner() != NewNode, TEXT("Requesting already \"seen\" nodes is invalid. Use RequestScene or RequestPreviousScene instead."));
-	}
+	checkf(!ExhaustedNodePositions.Contains(NewNode), TEXT("Requesting already \"seen\" nodes is invalid. Use RequestScene or RequestPreviousScene instead."));
 #endif
 
-	FScenario* Last = Node[SceneIndex];
-	ExhaustedScenes.Push(Last);
+	FScenario* Last = (*Node)[SceneIndex];
+	ExhaustedNodePositions.Add(Last->GetOwner(), ExhaustedScenes.Add(Last));
 
 	OnSceneEnd.Broadcast(*Last);
 
-	Node.Empty();
-	NewNode->GetAllRows(UE_SOURCE_LOCATION, Node);
+	RestoreVersions(NewNode);
+	Node = FScenarioNodeCache::Get().GetScenes(NewNode);
 
-	checkf(!Node.IsEmpty(), TEXT("Trying to jump to empty Data Table! - %s"), *NewNode->GetFName().ToString());
+	checkf(!Node->IsEmpty(), TEXT("Trying to jump to empty Data Table! - %s"), *NewNode->GetFName().ToString());
 
-	SceneHandles.Empty();
+	SceneResidency.Empty();
 	CancelNextScene();
 
 	SceneIndex = 0;
@@ -413,6 +472,9 @@ bool UVisualController::RequestNode(const UDataTable* NewNode)
 	TryPlaySceneSound(Head->Info.Sound);
 	PrepareScenes();
 
+	/*Scenes of the picked option are referenced by the new handles, other options are released*/
+	PrepareChoiceScenes();
+
 	OnSceneStart.Broadcast(*Head);
 
 	return true;
@@ -420,8 +482,13 @@ bool UVisualController::RequestNode(const UDataTable* NewNode)
 
 bool UVisualController::RequestFastMove(EVisualControllerDirection::Type Direction)
 {
-	if (IsIdle() && Direction != EVisualControllerDirection::None)
+	if (IsReady() && IsIdle() && Direction != EVisualControllerDirection::None)
 	{
+		if (bSkipIntermediateScenes)
+		{
+			return SkipFastMove(Direction);
+		}
+
 		FastMoveTask = MakeUnique<UE::VisualU::Private::FFastMoveAsyncTask>(this, Direction, bPlayTransitions, bPlaySound);
 		bPlayTransitions = false;
 		bPlaySound = false;
@@ -440,6 +507,32 @@ bool UVisualController::RequestFastMove(EVisualControllerDirection::Type Directi
 
 bool UVisualController::RequestAutoMove(EVisualControllerDirection::Type Direction)
 {
+	if (!IsReady())
+	{
+		return false;
+	}
+
+	if (AutoMovePacing == EVisualAutoMovePacing::Reading)
+	{
+		if (IsIdle() && Direction != EVisualControllerDirection::None)
+		{
+			Mode = EVisualControllerMode::AutoMoving;
+			AutoMoveDirection = Direction;
+
+			OnAutoMoveStart.Broadcast(Direction);
+
+			/*Current scene is read first*/
+			if (!IsScenePending())
+			{
+				ScheduleAutoMove();
+			}
+
+			return true;
+		}
+
+		return false;
+	}
+
 	const bool bIsDelayGood = (!FMath::IsNegativeOrNegativeZero(AutoMoveDelay) && !FMath::IsNearlyZero(AutoMoveDelay));
 
 	if (IsIdle() 
@@ -452,10 +545,15 @@ bool UVisualController::RequestAutoMove(EVisualControllerDirection::Type Directi
 
 		const auto AutoMove = [this, Direction](float DeltaTime) -> bool
 		{
+			if (IsScenePending())
+			{
+				return true;
+			}
+
 			const bool bIsForward = Direction == EVisualControllerDirection::Forward;
 			const bool bCanContinue = (bIsForward
-				? (!IsWithChoice() && RequestNextScene() && CanAdvanceScene())
-				: RequestPreviousScene() && CanRetractScene());
+				? (!IsWithChoice() && RequestNextScene())
+				: RequestPreviousScene()) && CanContinueAutoMove(Direction);
 
 			if (!bCanContinue)
 			{
@@ -480,15 +578,23 @@ bool UVisualController::RequestAutoMove(EVisualControllerDirection::Type Directi
 
 void UVisualController::CancelFastMove()
 {
-	if (IsFastMoving() && FastMoveTask.IsValid())
+	if (IsFastMoving() && (FastMoveTask.IsValid() || FastMoveHandle.IsValid()))
 	{
 		check(Renderer);
-		FastMoveTask->EnsureCompletion(/*bDoWorkOnThisThreadIfNotStarted=*/false);
-		FastMoveTask->Cancel();
-		FastMoveTask.Reset(nullptr);
+		if (FastMoveTask.IsValid())
+		{
+			FastMoveTask->EnsureCompletion(/*bDoWorkOnThisThreadIfNotStarted=*/false);
+			FastMoveTask->Cancel();
+			FastMoveTask.Reset(nullptr);
+		}
+
+		if (FastMoveHandle.IsValid())
+		{
+			FTSTicker::RemoveTicker(FastMoveHandle);
+			FastMoveHandle.Reset();
+		}
 
 		Renderer->DrawScene(GetCurrentScene());
-		SceneHandles.Empty();
 
 		Mode = EVisualControllerMode::Idle;
 
@@ -496,6 +602,12 @@ void UVisualController::CancelFastMove()
 	}
 }
 
+void UVisualController::CancelPendingScene()
+{
+	/*Handle waits on the resident scene, so it is not canceled*/
+	PendingSceneHandle.Reset();
+}
+
 void UVisualController::CancelAutoMove()
 {
 	if (IsAutoMoving())
@@ -504,8 +616,12 @@ void UVisualController::CancelAutoMove()
 		if (AutoMoveHandle.IsValid())
 		{
 			FTSTicker::RemoveTicker(AutoMoveHandle);
+			AutoMoveHandle.Reset();
 		}
 
+		AutoMoveDirection = EVisualControllerDirection::None;
+		bIsSceneRead = false;
+
 		Mode = EVisualControllerMode::Idle;
 
 		OnAutoMoveEnd.Broadcast();
@@ -521,9 +637,13 @@ void UVisualController::VisualizeToScreen(TSubclassOf<UVisualRenderer> RendererC
 	}
 
 	Renderer->AddToPlayerScreen(ZOrder);
-	const FScenario* CurrentScene = GetCurrentScene();
-	TSharedPtr<FStreamableHandle> CurrentSceneHandle = LoadScene(CurrentScene);
-	Renderer->DrawScene(CurrentScene);
+	/*First scene is drawn once controller is ready*/
+	if (IsReady())
+	{
+		const FScenario* CurrentScene = GetCurrentScene();
+		TSharedPtr<FStreamableHandle> CurrentSceneHandle = LoadScene(CurrentScene);
+		Renderer->DrawScene(CurrentScene);
+	}
 }
 
 void UVisualController::VisualizeToComponent(TSubclassOf<UVisualRenderer> RendererClass, UWidgetComponent* Component)
@@ -536,9 +656,13 @@ void UVisualController::VisualizeToComponent(TSubclassOf<UVisualRenderer> Render
 	}
 
 	Component->SetWidget(Renderer);
-	const FScenario* CurrentScene = GetCurrentScene();
-	TSharedPtr<FStreamableHandle> CurrentSceneHandle = LoadScene(CurrentScene);
-	Renderer->DrawScene(CurrentScene);
+	/*First scene is drawn once controller is ready*/
+	if (IsReady())
+	{
+		const FScenario* CurrentScene = GetCurrentScene();
+		TSharedPtr<FStreamableHandle> CurrentSceneHandle = LoadScene(CurrentScene);
+		Renderer->DrawScene(CurrentScene);
+	}
 }
 
 void UVisualController::RemoveFromScreen() const
@@ -574,6 +698,60 @@ void UVisualController::SetNumScenesToLoad(int32 Num)
 	}
 }
 
+void UVisualController::SetSceneMemoryBudget(int32 Megabytes)
+{
+	if (ensureMsgf(Megabytes > 0, TEXT("Expected positive value, set operation failed.")))
+	{
+		SceneMemoryBudget = Megabytes;
+	}
+}
+
+void UVisualController::SetNumChoiceScenesToLoad(int32 Num)
+{
+	if (ensureMsgf(Num >= 0, TEXT("Expected positive value, set operation failed.")))
+	{
+		ChoiceScenesToLoad = Num;
+	}
+}
+
+void UVisualController::ShouldSkipIntermediateScenes(bool bShouldSkip)
+{
+	bSkipIntermediateScenes = bShouldSkip;
+}
+
+void UVisualController::SetSkipFeedbackInterval(int32 Interval)
+{
+	if (ensureMsgf(Interval >= 0, TEXT("Expected positive value, set operation failed.")))
+	{
+		SkipFeedbackInterval = Interval;
+	}
+}
+
+void UVisualController::SetAdaptiveScenesToLoad(bool bShouldAdapt)
+{
+	bAdaptiveScenesToLoad = bShouldAdapt;
+}
+
+void UVisualController::SetScenesToLoadBounds(int32 Min, int32 Max)
+{
+	if (ensureMsgf(Min > 0 && Max >= Min, TEXT("Expected positive bounds with Min (%i) not larger than Max (%i), set operation failed."), Min, Max))
+	{
+		MinScenesToLoad = Min;
+		MaxScenesToLoad = Max;
+	}
+}
+
+float UVisualController::GetPrefetchHitRate() const
+{
+	const int32 NumRequests = PrefetchHits + PrefetchMisses;
+	return NumRequests > 0 ? StaticCast<float>(PrefetchHits) / NumRequests : 1.f;
+}
+
+void UVisualController::ShouldAdvanceSynchronously(bool bShouldAdvance)
+{
+	bSynchronousAdvance = bShouldAdvance;
+}
+
 void UVisualController::ShouldPlayTransitions(bool bShouldPlay)
 {
 	bPlayTransitions = bShouldPlay;
@@ -589,9 +767,38 @@ void UVisualController::SetAutoMoveDelay(float Delay)
 	AutoMoveDelay = Delay;
 }
 
+void UVisualController::SetAutoMovePacing(EVisualAutoMovePacing Pacing)
+{
+	AutoMovePacing = Pacing;
+}
+
+void UVisualController::SetAutoMoveTimePerCharacter(float Time)
+{
+	if (ensureMsgf(Time >= 0.f, TEXT("Expected positive value, set operation failed.")))
+	{
+		AutoMoveTimePerCharacter = Time;
+	}
+}
+
+void UVisualController::SetAutoMoveTextBlock(UVisualTextBlock* TextBlock)
+{
+	if (UVisualTextBlock* PreviousTextBlock = AutoMoveTextBlock.Get())
+	{
+		PreviousTextBlock->OnTypewriterEnd.RemoveDynamic(this, &UVisualController::OnAutoMoveLineTyped);
+	}
+
+	AutoMoveTextBlock = TextBlock;
+
+	if (TextBlock)
+	{
+		TextBlock->OnTypewriterEnd.AddUniqueDynamic(this, &UVisualController::OnAutoMoveLineTyped);
+	}
+}
+
 const FScenario* UVisualController::GetCurrentScene() const
 {
-	return Node[SceneIndex];
+	check(Node.IsValid());
+	return (*Node)[SceneIndex];
 }
 
 const FScenario& UVisualController::GetCurrentScenario() const
@@ -599,14 +806,24 @@ const FScenario& UVisualController::GetCurrentScenario() const
 	return *GetCurrentScene();
 }
 
+bool UVisualController::CanSave() const
+{
+	return SavedScenes.Num() >= 2 || (Node.IsValid() && Head);
+}
+
+bool UVisualController::IsLoadingSavedScenes() const
+{
+	return SavedScenes.Num() >= 2;
+}
+
 bool UVisualController::CanAdvanceScene() const
 {
-	return Node.IsValidIndex(SceneIndex + 1);
+	return Node.IsValid() && Node->IsValidIndex(SceneIndex + 1);
 }
 
 bool UVisualController::CanRetractScene() const
 {
-	return Node.IsValidIndex(SceneIndex - 1);
+	return Node.IsValid() && Node->IsValidIndex(SceneIndex - 1);
 }
 
 bool UVisualController::IsWithChoice() const
@@ -616,7 +833,9 @@ bool UVisualController::IsWithChoice() const
 
 bool UVisualController::IsSceneExhausted(const FScenario* Scene) const
 {
-	return ExhaustedScenes.Contains(Scene);
+	const int32* Position = Scene ? ExhaustedNodePositions.Find(Scene->GetOwner()) : nullptr;
+
+	return Position && ExhaustedScenes[*Position] == Scene;
 }
 
 bool UVisualController::IsScenarioExhausted(const FScenario& Scenario) const
@@ -649,11 +868,13 @@ const FString UVisualController::GetAsyncQueueDebugString() const
 {
 	FString DebugString;
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
-	for (TWeakPtr<FStreamableHandle> WeakSceneHandle : DebugSceneHandles)
+	DebugString = SceneResidency.GetDebugString();
+
+	for (const TSharedPtr<FStreamableHandle>& ChoiceSceneHandle : ChoiceSceneHandles)
 	{
-		if (TSharedPtr<FStreamableHandle> SceneHandle = WeakSceneHandle.Pin())
+		if (ChoiceSceneHandle.IsValid())
 		{
-			DebugString += FString::Printf(TEXT("%s Progress: %.2f\n"), *SceneHandle->GetDebugName(), SceneHandle->GetProgress());
+			DebugString += FString::Printf(TEXT("[Choice] %s Progress: %.2f\n"), *ChoiceSceneHandle->GetDebugName(), ChoiceSceneHandle->GetProgress());
 		}
 	}
 #endif
@@ -714,49 +935,66 @@ TSharedPtr<FStreamableHandle> UVisualController::LoadScene(const FScenario* Scen
 	return Handle;
 }
 
+TSharedPtr<FStreamableHandle> UVisualController::PinScene(const FScenario* Scene, int32 Priority)
+{
+	check(Scene);
+	const bool bIsResident = SceneResidency.Contains(Scene);
+	const TSharedPtr<FStreamableHandle> ResidentHandle = SceneResidency.Add(Scene, Priority);
+	if (!bIsResident)
+	{
+		TrackSceneLoadTime(ResidentHandle);
+	}
+
+	if (!ResidentHandle.IsValid() || ResidentHandle->HasLoadCompleted())
+	{
+		return nullptr;
+	}
+
+	/*Delegate of the resident handle is taken by load time tracking, so the caller waits on its own handle*/
+	TArray<TSharedPtr<FStreamableHandle>> ResidentHandles = { ResidentHandle };
+	return UAssetManager::GetStreamableManager().CreateCombinedHandle(ResidentHandles, ResidentHandle->GetDebugName());
+}
+
 void UVisualController::PrepareScenes(EVisualControllerDirection::Type Direction)
 {
 	check(Direction != EVisualControllerDirection::None);
+	SceneResidency.SetBudget(StaticCast<int64>(SceneMemoryBudget) * 1024 * 1024);
+
+	/*Scenes outside of the new window, including the ones already read, are released first*/
+	SceneResidency.DemoteAll();
+
+	const int32 Step = StaticCast<int32>(Direction);
 	if (ScenesToLoad > 0)
 	{
-		if (SceneHandles.IsEmpty())
+		const int32 NumScenes = ScenesToLoad + 1;
+		for (int32 i = 1; i <= NumScenes; i++)
 		{
-			for (int32 i = 1; i <= ScenesToLoad; i++)
+			const int32 Index = SceneIndex + i * Step;
+			if (!Node->IsValidIndex(Index))
 			{
-				const int32 u = Direction == EVisualControllerDirection::Forward ? i : -i;
-				if (Node.IsValidIndex(SceneIndex + u))
-				{
-					const FScenario* Scene = GetSceneAt(SceneIndex + u);
-					TSharedPtr<FStreamableHandle> SceneHandle = LoadSceneAsync(Scene);
-				
-#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
-					DebugSceneHandles.PushLast(SceneHandle);
-#endif
-					SceneHandles.Enqueue(MoveTemp(SceneHandle));
-				}
+				break;
 			}
 
-			return;
-		}
-
-		const int32 NextIndex = SceneIndex + (Direction == EVisualControllerDirection::Forward ? (ScenesToLoad + 1) : -(ScenesToLoad + 1));
-		if (Node.IsValidIndex(NextIndex))
-		{
-			TSharedPtr<FStreamableHandle> SceneHandle = LoadSceneAsync(GetSceneAt(NextIndex));
-#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
-			DebugSceneHandles.PushLast(SceneHandle);
-#endif
-			SceneHandles.Enqueue(MoveTemp(SceneHandle));
+			/*Closer scenes are more important*/
+			const int32 Priority = NumScenes - i;
+			const FScenario* Scene = GetSceneAt(Index);
+			if (!SceneResidency.Touch(Scene, Priority))
+			{
+				/*Only assets not used by other prepared scenes are requested*/
+				TrackSceneLoadTime(SceneResidency.Add(Scene, Priority));
+			}
 		}
+	}
 
-#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
-		if (!DebugSceneHandles.IsEmpty())
-		{
-			DebugSceneHandles.PopFirst();
-		}
-#endif
-		SceneHandles.Dequeue(NextSceneHandle);
+	/*Requested and pre-drawn scenes are resident even without prefetch*/
+	TArray<const FScenario*, TInlineAllocator<2>> ProtectedScenes;
+	ProtectedScenes.Add(GetCurrentScene());
+	if (Node->IsValidIndex(SceneIndex + Step))
+	{
+		ProtectedScenes.Add(GetSceneAt(SceneIndex + Step));
 	}
+
+	SceneResidency.Trim(ProtectedScenes);
 }
 
 void UVisualController::TryPlaySceneSound(TSoftObjectPtr<USoundBase> SceneSound) const
@@ -769,11 +1007,9 @@ void UVisualController::TryPlaySceneSound(TSoftObjectPtr<USoundBase> SceneSound)
 
 void UVisualController::CancelNextScene()
 {
-	if (NextSceneHandle.IsValid())
-	{
-		NextSceneHandle->CancelHandle();
-		NextSceneHandle.Reset();
-	}
+	/*Handles might wait on resident scenes, so they are not canceled*/
+	NextSceneHandle.Reset();
+	PreDrawHandle.Reset();
 }
 
 bool UVisualController::TryPlayTransition(const FScenario* From, const FScenario* To)
@@ -792,20 +1028,21 @@ void UVisualController::RollbackTo(const FScenario* Scene)
 {
 	check(Scene);
 	check(Renderer);
+	CancelPendingScene();
 	const UDataTable* SceneOwner = Scene->GetOwner();
 	const FScenario* CurrentScenario = GetCurrentScene();
 	const UDataTable* CurrentSceneOwner = CurrentScenario->GetOwner();
 	if (SceneOwner != CurrentSceneOwner)
 	{
 		NodeReferenceKeeper.Remove(CurrentSceneOwner);
-		Node.Empty();
 		NodeReferenceKeeper.Add(SceneOwner);
-		SceneOwner->GetAllRows(UE_SOURCE_LOCATION, Node);
+		RestoreVersions(SceneOwner);
+		Node = FScenarioNodeCache::Get().GetScenes(SceneOwner);
 	}
 
 	OnSceneEnd.Broadcast(*CurrentScenario);
 	
-	SceneHandles.Empty();
+	SceneResidency.Empty();
 	CancelNextScene();
 
 	SceneIndex = Scene->GetIndex();
@@ -814,6 +1051,12 @@ void UVisualController::RollbackTo(const FScenario* Scene)
 	TSharedPtr<FStreamableHandle> CurrentSceneHandle = LoadScene(CurrentScene);
 	Renderer->DrawScene(CurrentScene);
 	PrepareScenes(EVisualControllerDirection::Backward);
+	PrepareChoiceScenes();
+
+	if (IsAutoMoving() && AutoMovePacing == EVisualAutoMovePacing::Reading)
+	{
+		ScheduleAutoMove();
+	}
 
 	OnSceneStart.Broadcast(*CurrentScene);
 }
@@ -828,9 +1071,815 @@ UVisualVersioningSubsystem* UVisualController::TryGetVisualVersioningSubsystem()
 	return nullptr;
 }
 
+void UVisualController::RestoreVersions(const UDataTable* DataTable) const
+{
+	if (UVisualVersioningSubsystem* VisualVersioning = TryGetVisualVersioningSubsystem())
+	{
+		VisualVersioning->RestoreVersions(DataTable);
+	}
+}
+
 void UVisualController::AssertNextSceneLoad(EVisualControllerDirection::Type Direction)
 {
 	check(Direction != EVisualControllerDirection::None);
 	const int32 NextSceneIndex = SceneIndex + StaticCast<int32>(Direction);
 	NextSceneHandle = LoadScene(GetSceneAt(NextSceneIndex));
 }
+
+void UVisualController::AwaitNextSceneLoad(EVisualControllerDirection::Type Direction)
+{
+	check(Direction != EVisualControllerDirection::None);
+	check(!IsScenePending());
+	const int32 NextSceneIndex = SceneIndex + StaticCast<int32>(Direction);
+	const FScenario* NextScene = GetSceneAt(NextSceneIndex);
+
+	/*Prepared scenes are expected to be loaded already, their assets are held by the residency cache*/
+	if (SceneResidency.IsLoaded(NextScene))
+	{
+		NextSceneHandle.Reset();
+		ShowAdjacentScene(Direction);
+		return;
+	}
+
+	/*Assets that are requested by other resident scenes are not requested again*/
+	TSharedPtr<FStreamableHandle> SceneHandle = PinScene(NextScene, ScenesToLoad);
+	if (!SceneHandle.IsValid())
+	{
+		NextSceneHandle.Reset();
+		ShowAdjacentScene(Direction);
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_PendingSceneRequests);
+	PendingSceneHandle = SceneHandle;
+	SceneHandle->BindCompleteDelegate(FStreamableDelegate::CreateWeakLambda(this, [this, Direction, WeakSceneHandle = TWeakPtr<FStreamableHandle>(SceneHandle)]()
+	{
+		if (PendingSceneHandle.IsValid() && PendingSceneHandle == WeakSceneHandle.Pin())
+		{
+			NextSceneHandle = MoveTemp(PendingSceneHandle);
+			PendingSceneHandle.Reset();
+			ShowAdjacentScene(Direction);
+		}
+	}));
+
+	OnScenePending.Broadcast(Direction);
+}
+
+void UVisualController::PreDrawAdjacentScene(EVisualControllerDirection::Type Direction)
+{
+	check(Direction != EVisualControllerDirection::None);
+	check(Renderer);
+	const int32 AdjacentSceneIndex = SceneIndex + StaticCast<int32>(Direction);
+	if (!Renderer->IsDoubleBuffered() || !Node->IsValidIndex(AdjacentSceneIndex))
+	{
+		return;
+	}
+
+	const FScenario* AdjacentScene = GetSceneAt(AdjacentSceneIndex);
+	const auto PreDraw = [this, AdjacentScene, AdjacentSceneIndex]()
+	{
+		if (Renderer && Node.IsValid() && Node->IsValidIndex(AdjacentSceneIndex) && GetSceneAt(AdjacentSceneIndex) == AdjacentScene)
+		{
+			Renderer->PreDrawScene(AdjacentScene);
+		}
+	};
+
+	/*Prepared scenes are expected to be resident already, so the scene is usually built right away*/
+	PreDrawHandle = PinScene(AdjacentScene, ScenesToLoad);
+	if (PreDrawHandle.IsValid())
+	{
+		PreDrawHandle->BindCompleteDelegate(FStreamableDelegate::CreateWeakLambda(this, PreDraw));
+	}
+	else
+	{
+		PreDraw();
+	}
+}
+
+void UVisualController::ScheduleAutoMove()
+{
+	check(IsAutoMoving());
+	if (AutoMoveHandle.IsValid())
+	{
+		FTSTicker::RemoveTicker(AutoMoveHandle);
+		AutoMoveHandle.Reset();
+	}
+
+	bIsSceneRead = false;
+
+	const FScenario* CurrentScene = GetCurrentScene();
+	const float ReadingTime = UE::VisualU::Private::GetReadableLength(CurrentScene->Info.Line.ToString()) * AutoMoveTimePerCharacter;
+
+	float SoundDuration = 0.f;
+	if (USoundBase* Sound = CurrentScene->Info.Sound.Get(); Sound && bPlaySound)
+	{
+		/*Looping sound would never let the scene end*/
+		const float Duration = Sound->GetDuration();
+		SoundDuration = Duration < INDEFINITELY_LOOPING_DURATION ? Duration : 0.f;
+	}
+
+	float TransitionDuration = 0.f;
+	/*Only the transition into the current scene delays reading*/
+	if (Renderer && Renderer->IsTransitionInProgress())
+	{
+		const UVisualUSettings* VisualUSettings = GetDefault<UVisualUSettings>();
+		TransitionDuration = VisualUSettings ? VisualUSettings->TransitionDuration : 0.f;
+	}
+
+	const float Delay = FMath::Max3(ReadingTime, SoundDuration, TransitionDuration);
+	AutoMoveHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float)
+	{
+		AutoMoveHandle.Reset();
+		bIsSceneRead = true;
+		TryAutoMove();
+
+		return false;
+	}), Delay);
+}
+
+void UVisualController::TryAutoMove()
+{
+	/*Pending scene schedules its own reading once it is shown*/
+	if (!IsAutoMoving() || !bIsSceneRead || IsScenePending())
+	{
+		return;
+	}
+
+	/*Typewriter will notify when it is done*/
+	if (const UVisualTextBlock* TextBlock = AutoMoveTextBlock.Get(); TextBlock && !TextBlock->HasTypewriterFinished())
+	{
+		return;
+	}
+
+	bIsSceneRead = false;
+
+	const bool bIsForward = AutoMoveDirection == EVisualControllerDirection::Forward;
+	const bool bCanContinue = (bIsForward
+		? (!IsWithChoice() && RequestNextScene())
+		: RequestPreviousScene()) && CanContinueAutoMove(AutoMoveDirection);
+
+	if (!bCanContinue)
+	{
+		CancelAutoMove();
+	}
+}
+
+bool UVisualController::CanContinueAutoMove(EVisualControllerDirection::Type Direction) const
+{
+	check(Direction != EVisualControllerDirection::None);
+	/*Scene index is not moved until the pending scene is shown*/
+	const int32 Step = StaticCast<int32>(Direction);
+	const int32 RequestedSceneIndex = IsScenePending() ? SceneIndex + Step : SceneIndex;
+
+	return Node.IsValid() && Node->IsValidIndex(RequestedSceneIndex + Step);
+}
+
+void UVisualController::OnAutoMoveLineTyped()
+{
+	TryAutoMove();
+}
+
+int32 UVisualController::FindFastMoveTarget(EVisualControllerDirection::Type Direction) const
+{
+	check(Direction != EVisualControllerDirection::None);
+	check(Node.IsValid());
+	if (Direction == EVisualControllerDirection::Backward)
+	{
+		return 0;
+	}
+
+	int32 TargetIndex = SceneIndex;
+	while (Node->IsValidIndex(TargetIndex + 1))
+	{
+		const FScenario* Scene = (*Node)[TargetIndex];
+		if (Scene == Head || Scene->HasChoice())
+		{
+			break;
+		}
+
+		TargetIndex++;
+	}
+
+	return TargetIndex;
+}
+
+bool UVisualController::SkipFastMove(EVisualControllerDirection::Type Direction)
+{
+	check(Renderer);
+	const int32 TargetIndex = FindFastMoveTarget(Direction);
+	if (TargetIndex == SceneIndex || IsTransitioning() || IsScenePending())
+	{
+		return false;
+	}
+
+	Mode = EVisualControllerMode::FastMoving;
+
+	OnFastMoveStart.Broadcast(Direction);
+
+	if (SkipFeedbackInterval <= 0)
+	{
+		SkipTo(TargetIndex);
+
+		Mode = EVisualControllerMode::Idle;
+
+		OnFastMoveEnd.Broadcast();
+
+		return true;
+	}
+
+	FastMoveHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this, TargetIndex, Direction](float)
+	{
+		const int32 Step = (SkipFeedbackInterval + 1) * StaticCast<int32>(Direction);
+		const int32 NextIndex = Direction == EVisualControllerDirection::Forward
+			? FMath::Min(SceneIndex + Step, TargetIndex)
+			: FMath::Max(SceneIndex + Step, TargetIndex);
+
+		SkipTo(NextIndex);
+
+		if (NextIndex == TargetIndex)
+		{
+			FastMoveHandle.Reset();
+
+			Mode = EVisualControllerMode::Idle;
+
+			OnFastMoveEnd.Broadcast();
+
+			return false;
+		}
+
+		return true;
+	}));
+
+	return true;
+}
+
+void UVisualController::SkipTo(int32 TargetIndex)
+{
+	check(Renderer);
+	check(Node.IsValid() && Node->IsValidIndex(TargetIndex));
+	/*Scene requested before the skip would advance from the skipped index*/
+	CancelPendingScene();
+
+	if (TargetIndex < SceneIndex)
+	{
+		/*Moving backward reverts every left scene, as if they were requested one by one*/
+		if (UVisualVersioningSubsystem* VisualVersioning = TryGetVisualVersioningSubsystem())
+		{
+			for (int32 i = SceneIndex; i > TargetIndex; i--)
+			{
+				VisualVersioning->Checkout(const_cast<FScenario*>(GetSceneAt(i)));
+			}
+		}
+	}
+
+	OnSceneEnd.Broadcast(GetCurrentScenario());
+
+	CancelNextScene();
+
+	const EVisualControllerDirection::Type Direction = TargetIndex > SceneIndex
+		? EVisualControllerDirection::Forward
+		: EVisualControllerDirection::Backward;
+
+	SceneIndex = TargetIndex;
+
+	const FScenario* CurrentScene = GetCurrentScene();
+	if (SceneIndex > Head->GetIndex() && Head->GetOwner() == CurrentScene->GetOwner())
+	{
+		Head = CurrentScene;
+	}
+
+	TSharedPtr<FStreamableHandle> CurrentSceneHandle = LoadScene(CurrentScene);
+	Renderer->DrawScene(CurrentScene);
+	PrepareScenes(Direction);
+	PrepareChoiceScenes();
+
+	OnSceneStart.Broadcast(*CurrentScene);
+}
+
+void UVisualController::ShowAdjacentScene(EVisualControllerDirection::Type Direction)
+{
+	check(Direction != EVisualControllerDirection::None);
+	check(Renderer);
+	const bool bIsForward = Direction == EVisualControllerDirection::Forward;
+	if (!bIsForward)
+	{
+		if (UVisualVersioningSubsystem* VisualVersioning = TryGetVisualVersioningSubsystem())
+		{
+			VisualVersioning->Checkout(const_cast<FScenario*>(GetCurrentScene()));
+		}
+	}
+
+	OnSceneEnd.Broadcast(GetCurrentScenario());
+
+	SceneIndex += StaticCast<int32>(Direction);
+
+	const FScenario* CurrentScene = GetCurrentScene();
+	if (bIsForward)
+	{
+		if (SceneIndex > Head->GetIndex() && Head->GetOwner() == CurrentScene->GetOwner())
+		{
+			Head = CurrentScene;
+		}
+
+		if (!TryPlayTransition(GetSceneAt(SceneIndex - 1), CurrentScene))
+		{
+			Renderer->DrawScene(CurrentScene);
+		}
+
+		TryPlaySceneSound(CurrentScene->Info.Sound);
+	}
+	else
+	{
+		Renderer->DrawScene(CurrentScene);
+	}
+
+	CancelNextScene();
+
+	const double Now = FPlatformTime::Seconds();
+	if (LastAdvanceTime > 0.0)
+	{
+		const double Interval = FMath::Min(Now - LastAdvanceTime, UE::VisualU::Private::MaxAdvanceInterval);
+		AverageAdvanceInterval = AverageAdvanceInterval > 0.0
+			? FMath::Lerp(AverageAdvanceInterval, Interval, UE::VisualU::Private::PrefetchSmoothing)
+			: Interval;
+	}
+	LastAdvanceTime = Now;
+
+	AdaptScenesToLoad();
+	PrepareChoiceScenes();
+	PreDrawAdjacentScene(Direction);
+
+	if (IsAutoMoving() && AutoMovePacing == EVisualAutoMovePacing::Reading)
+	{
+		ScheduleAutoMove();
+	}
+
+	OnSceneStart.Broadcast(*CurrentScene);
+}
+
+void UVisualController::Initialize()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ControllerInitialization);
+	InitializationStartTime = FPlatformTime::Seconds();
+	SetInitializationProgress(0.f);
+
+	Renderer = CreateWidget<UVisualRenderer>(GetOuterAPlayerController(), UVisualRenderer::StaticClass());
+	check(Renderer);
+
+	/*Rebuild widget immediately to create renderer widgets*/
+	Renderer->TakeWidget();
+
+	if (bInitializeAsynchronously)
+	{
+		InitializeAsync();
+	}
+	else
+	{
+		const UVisualUSettings* VisualUSettings = GetDefault<UVisualUSettings>();
+		check(VisualUSettings);
+
+		checkf(!VisualUSettings->FirstDataTable.IsNull(), TEXT("Unable to find first data table, please specify one in project settings."));
+		SetFirstNode(FVisualStoryPack::LoadNode(VisualUSettings->FirstDataTable.ToSoftObjectPath()));
+
+		InitializationHandle = LoadScene(Head);
+		FinishInitialization();
+	}
+}
+
+void UVisualController::InitializeAsync()
+{
+	const UVisualUSettings* VisualUSettings = GetDefault<UVisualUSettings>();
+	check(VisualUSettings);
+
+	checkf(!VisualUSettings->FirstDataTable.IsNull(), TEXT("Unable to find first data table, please specify one in project settings."));
+	const FSoftObjectPath FirstNodePath = VisualUSettings->FirstDataTable.ToSoftObjectPath();
+
+	/*Node is in memory or can be created from the story pack without loading*/
+	const FVisualStoryPack* StoryPack = FVisualStoryPack::Get();
+	if (FirstNodePath.ResolveObject() || (StoryPack && StoryPack->Contains(FirstNodePath)))
+	{
+		OnFirstNodeLoaded();
+		return;
+	}
+
+	InitializationHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		FirstNodePath,
+		FStreamableDelegate(),
+		FStreamableManager::AsyncLoadHighPriority,
+		/*bManageActiveHandle=*/false,
+		/*bStartStalled=*/false,
+		TEXT("FirstDataTable"));
+
+	if (!InitializationHandle.IsValid() || InitializationHandle->HasLoadCompleted())
+	{
+		OnFirstNodeLoaded();
+		return;
+	}
+
+	/*First node is the first half of the initialization*/
+	InitializationHandle->BindUpdateDelegate(FStreamableUpdateDelegate::CreateWeakLambda(this, [this](TSharedRef<FStreamableHandle> Handle)
+	{
+		SetInitializationProgress(Handle->GetProgress() * 0.5f);
+	}));
+	InitializationHandle->BindCompleteDelegate(FStreamableDelegate::CreateUObject(this, &UVisualController::OnFirstNodeLoaded));
+}
+
+void UVisualController::OnFirstNodeLoaded()
+{
+	const UVisualUSettings* VisualUSettings = GetDefault<UVisualUSettings>();
+	check(VisualUSettings);
+
+	SetFirstNode(FVisualStoryPack::LoadNode(VisualUSettings->FirstDataTable.ToSoftObjectPath()));
+	SetInitializationProgress(0.5f);
+
+	InitializationHandle = LoadSceneAsync(Head);
+	if (!InitializationHandle.IsValid() || InitializationHandle->HasLoadCompleted())
+	{
+		FinishInitialization();
+		return;
+	}
+
+	InitializationHandle->BindUpdateDelegate(FStreamableUpdateDelegate::CreateWeakLambda(this, [this](TSharedRef<FStreamableHandle> Handle)
+	{
+		SetInitializationProgress(0.5f + Handle->GetProgress() * 0.5f);
+	}));
+	InitializationHandle->BindCompleteDelegate(FStreamableDelegate::CreateUObject(this, &UVisualController::FinishInitialization));
+}
+
+void UVisualController::SetFirstNode(const UDataTable* FirstNode)
+{
+	checkf(FirstNode, TEXT("Unable to load first data table %s."), *GetDefault<UVisualUSettings>()->FirstDataTable.ToString());
+	checkf(FirstNode->GetRowStruct()->IsChildOf(FScenario::StaticStruct()), TEXT("Data table must be based on FScenario struct."));
+	Node = FScenarioNodeCache::Get().GetScenes(FirstNode);
+
+	checkf(Node->IsValidIndex(0), TEXT("First Data Table is empty!"));
+	Head = GetCurrentScene();
+	NodeReferenceKeeper.Add(FirstNode);
+}
+
+void UVisualController::FinishInitialization()
+{
+	check(Renderer);
+	OnSceneStart.Broadcast(*Head);
+
+	Renderer->DrawScene(Head);
+	TryPlaySceneSound(Head->Info.Sound);
+	PrepareScenes();
+	PrepareChoiceScenes();
+
+	/*Assets of the first scene are held by renderer from now on*/
+	InitializationHandle.Reset();
+
+	bIsReady = true;
+	SetInitializationProgress(1.f);
+
+	UE_LOG(LogVisualU, Log, TEXT("Visual Controller initialized %s from %s in %.2f ms."),
+		bInitializeAsynchronously ? TEXT("asynchronously") : TEXT("synchronously"),
+		Head->GetOwner()->IsA<UVisualStoryPackTable>() ? TEXT("story pack") : TEXT("data table"),
+		(FPlatformTime::Seconds() - InitializationStartTime) * 1000.0);
+
+	OnControllerReady.Broadcast();
+}
+
+void UVisualController::CancelInitialization()
+{
+	if (InitializationHandle.IsValid())
+	{
+		InitializationHandle->CancelHandle();
+		InitializationHandle.Reset();
+	}
+}
+
+void UVisualController::SetInitializationProgress(float Progress)
+{
+	InitializationProgress = Progress;
+	OnInitializationProgress.Broadcast(InitializationProgress);
+}
+
+void UVisualController::LoadSavedScenesAsync()
+{
+	const bool bWasReady = bIsReady;
+	bIsReady = false;
+	InitializationStartTime = FPlatformTime::Seconds();
+	SetInitializationProgress(0.f);
+
+	const FVisualStoryPack* StoryPack = FVisualStoryPack::Get();
+	TSet<FSoftObjectPath> NodesToLoad;
+	for (const FSavedScene& SavedScene : SavedScenes)
+	{
+		/*Node is in memory or can be created from the story pack without loading*/
+		if (SavedScene.Owner.IsNull() 
+			|| SavedScene.Owner.ResolveObject() 
+			|| (StoryPack && StoryPack->FindOrCreateNode(SavedScene.Owner)))
+		{
+			continue;
+		}
+
+		NodesToLoad.Add(SavedScene.Owner);
+	}
+
+	if (NodesToLoad.IsEmpty())
+	{
+		FinishLoadingSavedScenes(bWasReady);
+		return;
+	}
+
+	InitializationHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		NodesToLoad.Array(),
+		FStreamableDelegate::CreateWeakLambda(this, [this, bWasReady]()
+		{
+			FinishLoadingSavedScenes(bWasReady);
+		}),
+		FStreamableManager::AsyncLoadHighPriority,
+		/*bManageActiveHandle=*/false,
+		/*bStartStalled=*/false,
+		TEXT("SavedNodes"));
+
+	if (!InitializationHandle.IsValid() || InitializationHandle->HasLoadCompleted())
+	{
+		FinishLoadingSavedScenes(bWasReady);
+		return;
+	}
+
+	InitializationHandle->BindUpdateDelegate(FStreamableUpdateDelegate::CreateWeakLambda(this, [this](TSharedRef<FStreamableHandle> Handle)
+	{
+		SetInitializationProgress(Handle->GetProgress());
+	}));
+}
+
+void UVisualController::FinishLoadingSavedScenes(bool bWasReady)
+{
+	/*Completion delegate might be called after the state is restored*/
+	if (SavedScenes.Num() < 2)
+	{
+		return;
+	}
+
+	const TArray<FSavedScene> Scenes = MoveTemp(SavedScenes);
+	SavedScenes.Reset();
+
+	/*State of the previous story is replaced, its scenes might be reallocated by now*/
+	ExhaustedScenes.Reset();
+	ExhaustedNodePositions.Reset();
+	NodeReferenceKeeper.Reset();
+	SceneResidency.Empty();
+	CancelNextScene();
+	CancelChoiceScenes();
+
+	const auto ResolveSavedScene = [](const FSavedScene& SavedScene) -> FScenario*
+	{
+		const UDataTable* Owner = SavedScene.Owner.IsNull() ? nullptr : FVisualStoryPack::LoadNode(SavedScene.Owner);
+		if (ensure(Owner))
+		{
+			FScenario* ResolvedScene = FScenarioNodeCache::Get().GetSceneAt(Owner, SavedScene.Index);
+			ensure(ResolvedScene);
+
+			return ResolvedScene;
+		}
+
+		return nullptr;
+	};
+
+	const int32 NumExhaustedScenes = Scenes.Num() - 2;
+	ExhaustedScenes.Reserve(NumExhaustedScenes);
+	ExhaustedNodePositions.Reserve(NumExhaustedScenes);
+	for (int32 i = 0; i < NumExhaustedScenes; i++)
+	{
+		if (FScenario* ResolvedScene = ResolveSavedScene(Scenes[i]))
+		{
+			ExhaustedNodePositions.Add(ResolvedScene->GetOwner(), ExhaustedScenes.Add(ResolvedScene));
+			NodeReferenceKeeper.Add(ResolvedScene->GetOwner());
+		}
+	}
+
+	/*Nodes of the history are entered again by moving back*/
+	for (const TPair<const UDataTable*, int32>& ExhaustedNode : ExhaustedNodePositions)
+	{
+		RestoreVersions(ExhaustedNode.Key);
+	}
+
+	const FSavedScene& CurrentScenario = Scenes[NumExhaustedScenes];
+	if (const UDataTable* CurrentOwner = CurrentScenario.Owner.IsNull() ? nullptr : FVisualStoryPack::LoadNode(CurrentScenario.Owner))
+	{
+		RestoreVersions(CurrentOwner);
+		Node = FScenarioNodeCache::Get().GetScenes(CurrentOwner);
+		NodeReferenceKeeper.Add(CurrentOwner);
+	}
+	SceneIndex = CurrentScenario.Index;
+
+	Head = ResolveSavedScene(Scenes[NumExhaustedScenes + 1]);
+	if (Head)
+	{
+		NodeReferenceKeeper.Add(Head->GetOwner());
+	}
+
+	/*Nodes are referenced by resolved scenes from now on*/
+	InitializationHandle.Reset();
+
+	if (UWorld* World = GetWorld(); World && World->GetBegunPlay())
+	{
+		const FScenario* CurrentScene = GetCurrentScene();
+		TSharedPtr<FStreamableHandle> CurrentSceneHandle = LoadScene(CurrentScene);
+		Renderer->DrawScene(CurrentScene);
+		TryPlaySceneSound(CurrentScene->Info.Sound);
+		PrepareScenes();
+		PrepareChoiceScenes();
+
+		OnSceneStart.Broadcast(*CurrentScene);
+
+		if (!bIsReady)
+		{
+			bIsReady = true;
+			SetInitializationProgress(1.f);
+
+			UE_CLOG(bLoadAsynchronously, LogVisualU, Log, TEXT("Visual Controller loaded %i scenes in %.2f ms."),
+				Scenes.Num(),
+				(FPlatformTime::Seconds() - InitializationStartTime) * 1000.0);
+
+			OnControllerReady.Broadcast();
+		}
+	}
+	else
+	{
+		bIsReady = bWasReady;
+	}
+
+	OnSavedScenesLoaded.Broadcast();
+}
+
+void UVisualController::PrepareChoiceScenes()
+{
+	const FScenario* CurrentScene = GetCurrentScene();
+	if (CurrentScene == PreparedChoice)
+	{
+		return;
+	}
+
+	CancelChoiceScenes();
+
+	if (ChoiceScenesToLoad <= 0 || !CurrentScene->HasChoice() || CurrentScene->ChoiceTargets.IsEmpty())
+	{
+		return;
+	}
+
+	const FVisualStoryPack* StoryPack = FVisualStoryPack::Get();
+	TArray<FSoftObjectPath> TargetsToLoad;
+	TArray<TWeakObjectPtr<const UDataTable>> PackedTargets;
+	TargetsToLoad.Reserve(CurrentScene->ChoiceTargets.Num());
+	for (const TSoftObjectPtr<UDataTable>& ChoiceTarget : CurrentScene->ChoiceTargets)
+	{
+		if (!ChoiceTarget.IsNull())
+		{
+			/*Packed nodes are created in memory, so they don't need to be loaded*/
+			if (StoryPack)
+			{
+				if (const UDataTable* PackedNode = StoryPack->FindOrCreateNode(ChoiceTarget.ToSoftObjectPath()))
+				{
+					PackedTargets.AddUnique(PackedNode);
+					continue;
+				}
+			}
+			TargetsToLoad.AddUnique(ChoiceTarget.ToSoftObjectPath());
+		}
+	}
+
+	PreparedChoice = CurrentScene;
+
+	FString DebugString = TEXT("ChoiceTargets");
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	DebugString = CurrentScene->GetDebugString();
+#endif
+	const auto PrepareChoiceNodes = [this, CurrentScene, PackedTargets]()
+	{
+		if (PreparedChoice != CurrentScene || !ChoiceSceneHandles.IsEmpty())
+		{
+			return;
+		}
+
+		TArray<const UDataTable*> ChoiceNodes;
+		for (const TWeakObjectPtr<const UDataTable>& PackedTarget : PackedTargets)
+		{
+			ChoiceNodes.Add(PackedTarget.Get());
+		}
+
+		if (ChoiceTargetsHandle.IsValid())
+		{
+			TArray<UObject*> LoadedTargets;
+			ChoiceTargetsHandle->GetLoadedAssets(LoadedTargets);
+			for (UObject* LoadedTarget : LoadedTargets)
+			{
+				ChoiceNodes.Add(Cast<UDataTable>(LoadedTarget));
+			}
+		}
+
+		for (const UDataTable* ChoiceNode : ChoiceNodes)
+		{
+			if (!ChoiceNode || !ChoiceNode->GetRowStruct() || !ChoiceNode->GetRowStruct()->IsChildOf(FScenario::StaticStruct()))
+			{
+				continue;
+			}
+
+			/*Assets of the prepared scenes depend on their versions*/
+			RestoreVersions(ChoiceNode);
+			const TSharedRef<const TArray<FScenario*>> ChoiceScenes = FScenarioNodeCache::Get().GetScenes(ChoiceNode);
+			const int32 NumScenes = FMath::Min(ChoiceScenesToLoad, ChoiceScenes->Num());
+			for (int32 i = 0; i < NumScenes; i++)
+			{
+				/*Choice scenes are released before the prepared scenes of the current node*/
+				if (TSharedPtr<FStreamableHandle> ChoiceSceneHandle = PinScene((*ChoiceScenes)[i], 0))
+				{
+					ChoiceSceneHandles.Add(MoveTemp(ChoiceSceneHandle));
+				}
+			}
+		}
+	};
+
+	if (!TargetsToLoad.IsEmpty())
+	{
+		ChoiceTargetsHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+			TargetsToLoad,
+			FStreamableDelegate::CreateWeakLambda(this, PrepareChoiceNodes),
+			FStreamableManager::AsyncLoadHighPriority,
+			/*bManageActiveHandle=*/false,
+			/*bStartStalled=*/false,
+			DebugString);
+	}
+
+	/*Packed nodes and loaded nodes don't have to wait for the streamable handle*/
+	if (!ChoiceTargetsHandle.IsValid() || ChoiceTargetsHandle->HasLoadCompleted())
+	{
+		PrepareChoiceNodes();
+	}
+}
+
+void UVisualController::CancelChoiceScenes()
+{
+	/*Assets of the choice scenes are held by the residency cache until it is trimmed*/
+	ChoiceSceneHandles.Empty();
+
+	if (ChoiceTargetsHandle.IsValid())
+	{
+		ChoiceTargetsHandle->CancelHandle();
+		ChoiceTargetsHandle.Reset();
+	}
+
+	PreparedChoice = nullptr;
+}
+
+bool UVisualController::IsSceneLoaded(const FScenario* Scene) const
+{
+	check(Scene);
+	TArray<FSoftObjectPath> DataToLoad;
+	Scene->GetDataToLoad(DataToLoad);
+
+	return Algo::AllOf(DataToLoad, [](const FSoftObjectPath& Path) { return Path.IsNull() || Path.ResolveObject() != nullptr; });
+}
+
+void UVisualController::TrackPrefetch(EVisualControllerDirection::Type Direction)
+{
+	check(Direction != EVisualControllerDirection::None);
+	if (IsSceneLoaded(GetSceneAt(SceneIndex + StaticCast<int32>(Direction))))
+	{
+		PrefetchHits++;
+	}
+	else
+	{
+		PrefetchMisses++;
+	}
+
+	SET_FLOAT_STAT(STAT_PrefetchHitRate, GetPrefetchHitRate());
+}
+
+void UVisualController::TrackSceneLoadTime(const TSharedPtr<FStreamableHandle>& SceneHandle)
+{
+	/*Scenes that are already in memory say nothing about storage speed*/
+	if (!bAdaptiveScenesToLoad || !SceneHandle.IsValid() || SceneHandle->HasLoadCompleted())
+	{
+		return;
+	}
+
+	/*Handle is owned by the resident scene, so its delegate is not shared with other requests*/
+	SceneHandle->BindCompleteDelegate(FStreamableDelegate::CreateWeakLambda(this, [this, RequestTime = FPlatformTime::Seconds()]()
+	{
+		const double LoadTime = FPlatformTime::Seconds() - RequestTime;
+		AverageSceneLoadTime = AverageSceneLoadTime > 0.0
+			? FMath::Lerp(AverageSceneLoadTime, LoadTime, UE::VisualU::Private::PrefetchSmoothing)
+			: LoadTime;
+
+		SET_FLOAT_STAT(STAT_AverageSceneLoadTime, AverageSceneLoadTime * 1000.0);
+	}));
+}
+
+void UVisualController::AdaptScenesToLoad()
+{
+	if (!bAdaptiveScenesToLoad || AverageAdvanceInterval <= 0.0)
+	{
+		return;
+	}
+
+	/*Enough scenes to cover the load time at the current pace, plus the one being requested*/
+	const int32 Depth = FMath::CeilToInt32(AverageSceneLoadTime / AverageAdvanceInterval) + 1;
+	ScenesToLoad = FMath::Clamp(Depth, MinScenesToLoad, FMath::Max(MinScenesToLoad, MaxScenesToLoad));
+
+	SET_DWORD_STAT(STAT_ScenesToLoad, ScenesToLoad);
+}
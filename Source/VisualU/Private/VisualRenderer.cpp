@@ -23,15 +23,30 @@
 #include "VisualDefaults.h"
 #include "VisualUSettings.h"
 #include "BackgroundVisualImage.h"
+#include "VisualU.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Constructed Sprites"), STAT_ConstructedSprites, STATGROUP_VisualU);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Reused Sprites"), STAT_ReusedSprites, STATGROUP_VisualU);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Sprites"), STAT_PooledSprites, STATGROUP_VisualU);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Kept Sprites"), STAT_KeptSprites, STATGROUP_VisualU);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Updated Sprites"), STAT_UpdatedSprites, STATGROUP_VisualU);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Swapped Scene Buffers"), STAT_SwappedSceneBuffers, STATGROUP_VisualU);
+DECLARE_CYCLE_STAT(TEXT("Pre-Draw Scene"), STAT_PreDrawScene, STATGROUP_VisualU);
+DECLARE_CYCLE_STAT(TEXT("Process Sprite Requests"), STAT_ProcessSpriteRequests, STATGROUP_VisualU);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Sprite Construction Time (ms)"), STAT_SpriteConstructionTime, STATGROUP_VisualU);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pending Sprites"), STAT_PendingSprites, STATGROUP_VisualU);
 
 UVisualRenderer::UVisualRenderer(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer),
 	Transition(nullptr),
 	TransitionHandle(),
 	FinalScene(nullptr),
+	DeferredPreDrawScene(nullptr),
 	Background(nullptr),
 	Canvas(nullptr),
-	DrawHandle()
+	SceneBuffers(),
+	FrontBufferIndex(0),
+	bIsDoubleBuffered(false)
 {
 }
 
@@ -40,117 +55,343 @@ void UVisualRenderer::DrawScene(const FScenario* Scene)
 	check(Scene);
 	check(WidgetTree);
 
-	ForEachSprite([this](UVisualSprite* Sprite) 
+	if (!Scene->Info.Background.BackgroundArtInfo.Expression.IsNull())
 	{
-		Canvas->RemoveChild(Sprite);
-		WidgetTree->RemoveWidget(Sprite);
+		Background->AssignVisualImageInfo(Scene->Info.Background.BackgroundArtInfo);
+	}
 
-		Sprite->OnSpriteDisappear.Broadcast();
-	});
+	if (bIsDoubleBuffered && GetBackBuffer().Scene == Scene)
+	{
+		/*Scene might be altered after it was pre-drawn, so changes are applied before the swap*/
+		BuildScene(1 - FrontBufferIndex, Scene);
+		SwapBuffers();
+		return;
+	}
 
-	if (!Scene->Info.Background.BackgroundArtInfo.Expression.IsNull())
+	BuildScene(FrontBufferIndex, Scene);
+}
+
+void UVisualRenderer::PreDrawScene(const FScenario* Scene)
+{
+	check(Scene);
+	check(WidgetTree);
+	if (!bIsDoubleBuffered)
 	{
-		Background->AssignVisualImageInfo(Scene->Info.Background.BackgroundArtInfo);
+		return;
 	}
-	
-	using FDrawRequest = TDelegate<void()>;
 
-	TArray<FDrawRequest> SpriteDrawRequests;
-	SpriteDrawRequests.Reserve(Scene->Info.SpritesParams.Num());
+	/*Hidden buffer might hold the final scene of the transition*/
+	if (IsTransitionInProgress())
+	{
+		DeferredPreDrawScene = Scene;
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_PreDrawScene);
+	BuildScene(1 - FrontBufferIndex, Scene);
+}
 
+void UVisualRenderer::BuildScene(int32 BufferIndex, const FScenario* Scene)
+{
+	check(Scene);
+	FVisualSceneBuffer& Buffer = SceneBuffers[BufferIndex];
+	check(Buffer.Canvas);
+
+	/*Sprites of the previous scene might still wait for construction or placement, their data is not applied yet*/
+	TMap<int32, FVisualSpriteRequest, TInlineSetAllocator<8>> StaleSprites;
+	for (const FVisualSpriteRequest& Request : CancelSpriteRequests(Buffer))
+	{
+		if (IsValid(Buffer.Sprites[Request.Index]))
+		{
+			StaleSprites.Add(Request.Index, Request);
+		}
+	}
+
+	/*Sprites of the previous scene are matched by class and occurrence of the class*/
+	TArray<TObjectPtr<UVisualSprite>> PreviousSprites = MoveTemp(Buffer.Sprites);
+	TArray<FSprite> PreviousSpriteData = MoveTemp(Buffer.SpriteData);
+	Buffer.Sprites.Reset();
+	Buffer.SpriteData.Reset();
+	Buffer.Scene = Scene;
+
+	TMap<TPair<UClass*, int32>, int32, TInlineSetAllocator<8>> PreviousSpriteKeys;
+	{
+		TMap<UClass*, int32, TInlineSetAllocator<8>> Occurrences;
+		for (int32 i = 0; i < PreviousSprites.Num(); i++)
+		{
+			if (IsValid(PreviousSprites[i]))
+			{
+				UClass* SpriteClass = PreviousSprites[i]->GetClass();
+				PreviousSpriteKeys.Add(TPair<UClass*, int32>(SpriteClass, Occurrences.FindOrAdd(SpriteClass)++), i);
+			}
+		}
+	}
+
+	TMap<UClass*, int32, TInlineSetAllocator<8>> Occurrences;
 	for (const FSprite& SpriteData : Scene->Info.SpritesParams)
 	{
 		if (UClass* const SpriteClass = SpriteData.SpriteClass.Get())
 		{
-			const FName SpriteName = SpriteClass->GetFName();
-			UVisualSprite* Sprite = WidgetTree->ConstructWidget<UVisualSprite>(SpriteClass, SpriteName);
-			ESlateVisibility FinalVisibility = Sprite->GetVisibility();
-			Sprite->SetVisibility(ESlateVisibility::Hidden);
-			Sprite->AssignSpriteInfo(SpriteData.SpriteInfo);
+			const TPair<UClass*, int32> SpriteKey(SpriteClass, Occurrences.FindOrAdd(SpriteClass)++);
 
-			UCanvasPanelSlot* SpriteSlot = Canvas->AddChildToCanvas(Sprite);
-			check(SpriteSlot);
+			int32 PreviousIndex = INDEX_NONE;
+			PreviousSpriteKeys.RemoveAndCopyValue(SpriteKey, PreviousIndex);
 
-			SpriteSlot->SetZOrder(SpriteData.ZOrder);
-			SpriteSlot->SetAnchors(SpriteData.Anchors);
-			SpriteSlot->SetAutoSize(true);
-			
-			SpriteDrawRequests.Add(FDrawRequest::CreateWeakLambda(this, [this, SpriteName, SpriteData, FinalVisibility]
+			const int32 Index = Buffer.SpriteData.Add(SpriteData);
+			if (PreviousIndex == INDEX_NONE)
+			{
+				/*Sprite is acquired when its request is processed. Pooled sprite is collapsed, so visibility is taken from the class*/
+				Buffer.Sprites.Add(nullptr);
+				const ESlateVisibility FinalVisibility = SpriteClass->GetDefaultObject<UVisualSprite>()->GetVisibility();
+				Buffer.PendingSprites.Emplace(Index, FinalVisibility, /*bInIsNewSprite=*/true, /*bInAssignSpriteInfo=*/true);
+				continue;
+			}
+
+			UVisualSprite* Sprite = PreviousSprites[PreviousIndex];
+			PreviousSprites[PreviousIndex] = nullptr;
+			Buffer.Sprites.Add(Sprite);
+
+			if (const FVisualSpriteRequest* StaleSprite = StaleSprites.Find(PreviousIndex))
+			{
+				/*Sprite is updated and placed as if its cancelled request was never made*/
+				INC_DWORD_STAT(STAT_UpdatedSprites);
+				FVisualSpriteRequest& Request = Buffer.PendingSprites.Emplace_GetRef(Index, StaleSprite->FinalVisibility, /*bInIsNewSprite=*/false, /*bInAssignSpriteInfo=*/true);
+				Request.bBroadcastAppear = StaleSprite->bBroadcastAppear;
+				continue;
+			}
+
+			const FSprite& PreviousData = PreviousSpriteData[PreviousIndex];
+			if (PreviousData == SpriteData)
 			{
-				UVisualSprite* Sprite = WidgetTree->FindWidget<UVisualSprite>(SpriteName);
-
-				if (IsValid(Sprite) && IsValid(Sprite->Slot))
-				{
-					const FVector2D Size = Sprite->GetDesiredSize();
-
-					const bool bZeroAnchors = (SpriteData.Anchors.Minimum.IsZero() || SpriteData.Anchors.Maximum.IsZero());
-					const float XAnchor =
-						bZeroAnchors
-						? 0.f
-						: FMath::IsNearlyEqual(SpriteData.Anchors.Minimum.X, SpriteData.Anchors.Maximum.X)
-						? SpriteData.Anchors.Minimum.X
-						: FMath::Abs(SpriteData.Anchors.Maximum.X - SpriteData.Anchors.Minimum.X);
-
-					const float YAnchor =
-						bZeroAnchors
-						? 0.f
-						: FMath::IsNearlyEqual(SpriteData.Anchors.Minimum.Y, SpriteData.Anchors.Maximum.Y)
-						? SpriteData.Anchors.Minimum.Y
-						: FMath::Abs(SpriteData.Anchors.Maximum.Y - SpriteData.Anchors.Minimum.Y);
-
-					const FVector2D AnchorModifier = FVector2D(XAnchor, YAnchor);
-					const FVector2D SpritePosition = (Size * AnchorModifier * -1) + SpriteData.Position;
-
-					UCanvasPanelSlot* SpriteSlot = Cast<UCanvasPanelSlot>(Sprite->Slot);
-					check(SpriteSlot);
-
-					SpriteSlot->SetPosition(SpritePosition);
-					Sprite->SetVisibility(FinalVisibility);
-
-					Sprite->OnSpriteAppear.Broadcast();
-				}
-			}));
+				INC_DWORD_STAT(STAT_KeptSprites);
+				continue;
+			}
+
+			INC_DWORD_STAT(STAT_UpdatedSprites);
+			const bool bAssignSpriteInfo = PreviousData.SpriteInfo != SpriteData.SpriteInfo;
+			Buffer.PendingSprites.Emplace(Index, Sprite->GetVisibility(), /*bInIsNewSprite=*/false, bAssignSpriteInfo);
+		}
+	}
+
+	/*Sprites that are not in the new scene*/
+	for (UVisualSprite* PreviousSprite : PreviousSprites)
+	{
+		if (IsValid(PreviousSprite))
+		{
+			ReleaseSprite(Buffer, PreviousSprite);
 		}
 	}
 
-	/*give time for Slate to fill in the cache so that it is possible to calculate position*/
-	DrawHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this, SpriteDrawRequests](float)
+	/*Sprites behind appear first when construction takes several frames*/
+	Buffer.PendingSprites.StableSort([&Buffer](const FVisualSpriteRequest& A, const FVisualSpriteRequest& B)
+	{
+		return Buffer.SpriteData[A.Index].ZOrder < Buffer.SpriteData[B.Index].ZOrder;
+	});
+
+	if (ProcessSpriteRequests(BufferIndex))
 	{
-		static int32 Frames = 0;
+		Buffer.DrawHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this, BufferIndex](float)
+		{
+			const bool bHasPendingSprites = ProcessSpriteRequests(BufferIndex);
+			if (!bHasPendingSprites)
+			{
+				SceneBuffers[BufferIndex].DrawHandle.Reset();
+			}
 
-		Frames++;
+			return bHasPendingSprites;
+		}));
+	}
+}
 
-		/*Skip first frame*/
-		if (Frames == 1)
+bool UVisualRenderer::ProcessSpriteRequests(int32 BufferIndex)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProcessSpriteRequests);
+	FVisualSceneBuffer& Buffer = SceneBuffers[BufferIndex];
+	const double Budget = GetDefault<UVisualUSettings>()->SpriteConstructionBudget / 1000.0;
+	const double StartTime = FPlatformTime::Seconds();
+
+	/*At least one sprite is processed per frame*/
+	int32 NumProcessed = 0;
+	while (NumProcessed < Buffer.PendingSprites.Num())
+	{
+		if (Budget > 0.0 && NumProcessed > 0 && FPlatformTime::Seconds() - StartTime >= Budget)
 		{
-			return true;
+			break;
 		}
-		/*Force layout prepass on second frame*/
-		else if (Frames == 2)
+
+		const FVisualSpriteRequest& Request = Buffer.PendingSprites[NumProcessed++];
+		const FSprite& SpriteData = Buffer.SpriteData[Request.Index];
+		UVisualSprite* Sprite = Buffer.Sprites[Request.Index];
+		if (Request.bIsNewSprite)
 		{
-			ForEachSprite([](UVisualSprite* Sprite)
+			UClass* const SpriteClass = SpriteData.SpriteClass.Get();
+			if (!SpriteClass)
+			{
+				continue;
+			}
+
+			Sprite = AcquireSprite(Buffer, SpriteClass);
+			Buffer.Sprites[Request.Index] = Sprite;
+			Sprite->SetVisibility(ESlateVisibility::Hidden);
+		}
+		else if (!IsValid(Sprite))
+		{
+			continue;
+		}
+
+		if (Request.bAssignSpriteInfo)
+		{
+			Sprite->AssignSpriteInfo(SpriteData.SpriteInfo);
+		}
+
+		UCanvasPanelSlot* SpriteSlot = Cast<UCanvasPanelSlot>(Sprite->Slot);
+		check(SpriteSlot);
+
+		SpriteSlot->SetZOrder(SpriteData.ZOrder);
+		SpriteSlot->SetAnchors(SpriteData.Anchors);
+		SpriteSlot->SetAutoSize(true);
+
+		/*Size of the sprite might be changed, so position is updated after layout*/
+		Buffer.SpritesToPlace.Add(Request);
+	}
+
+	Buffer.PendingSprites.RemoveAt(0, NumProcessed, EAllowShrinking::No);
+	SET_FLOAT_STAT(STAT_SpriteConstructionTime, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	SET_DWORD_STAT(STAT_PendingSprites, Buffer.PendingSprites.Num());
+
+	/*Synchronous prepass computes desired size of the sprites, so they are placed in the same frame*/
+	bool bCanPlaceSprites = true;
+	for (const FVisualSpriteRequest& Request : Buffer.SpritesToPlace)
+	{
+		const UVisualSprite* Sprite = Buffer.Sprites[Request.Index];
+		if (IsValid(Sprite) && !Sprite->GetCachedWidget().IsValid())
+		{
+			/*Slate widgets of the sprites are constructed with the renderer*/
+			bCanPlaceSprites = false;
+			break;
+		}
+	}
+
+	if (bCanPlaceSprites)
+	{
+		for (const FVisualSpriteRequest& Request : Buffer.SpritesToPlace)
+		{
+			if (UVisualSprite* Sprite = Buffer.Sprites[Request.Index]; IsValid(Sprite))
 			{
 				Sprite->ForceLayoutPrepass();
-			});
+			}
+		}
 
-			return true;
+		for (const FVisualSpriteRequest& Request : Buffer.SpritesToPlace)
+		{
+			PlaceSprite(BufferIndex, Request);
 		}
-		/*Skip third frame*/
-		else if (Frames == 3)
+
+		Buffer.SpritesToPlace.Reset();
+	}
+
+	return !Buffer.PendingSprites.IsEmpty() || !Buffer.SpritesToPlace.IsEmpty();
+}
+
+void UVisualRenderer::PlaceSprite(int32 BufferIndex, const FVisualSpriteRequest& Request)
+{
+	const FVisualSceneBuffer& Buffer = SceneBuffers[BufferIndex];
+	UVisualSprite* Sprite = Buffer.Sprites[Request.Index];
+
+	if (IsValid(Sprite) && IsValid(Sprite->Slot))
+	{
+		const FSprite& SpriteData = Buffer.SpriteData[Request.Index];
+		const FVector2D Size = Sprite->GetDesiredSize();
+
+		const bool bZeroAnchors = (SpriteData.Anchors.Minimum.IsZero() || SpriteData.Anchors.Maximum.IsZero());
+		const float XAnchor =
+			bZeroAnchors
+			? 0.f
+			: FMath::IsNearlyEqual(SpriteData.Anchors.Minimum.X, SpriteData.Anchors.Maximum.X)
+			? SpriteData.Anchors.Minimum.X
+			: FMath::Abs(SpriteData.Anchors.Maximum.X - SpriteData.Anchors.Minimum.X);
+
+		const float YAnchor =
+			bZeroAnchors
+			? 0.f
+			: FMath::IsNearlyEqual(SpriteData.Anchors.Minimum.Y, SpriteData.Anchors.Maximum.Y)
+			? SpriteData.Anchors.Minimum.Y
+			: FMath::Abs(SpriteData.Anchors.Maximum.Y - SpriteData.Anchors.Minimum.Y);
+
+		const FVector2D AnchorModifier = FVector2D(XAnchor, YAnchor);
+		const FVector2D SpritePosition = (Size * AnchorModifier * -1) + SpriteData.Position;
+
+		UCanvasPanelSlot* SpriteSlot = Cast<UCanvasPanelSlot>(Sprite->Slot);
+		check(SpriteSlot);
+
+		SpriteSlot->SetPosition(SpritePosition);
+		Sprite->SetVisibility(Request.FinalVisibility);
+
+		/*Sprites of the hidden buffer appear when buffers are swapped*/
+		if (Request.bBroadcastAppear && BufferIndex == FrontBufferIndex)
 		{
-			return true;
+			Sprite->OnSpriteAppear.Broadcast();
 		}
-		
-		/*Finally render the sprites on fifth frame*/
-		for (const FDrawRequest& DrawRequest : SpriteDrawRequests)
+	}
+}
+
+TArray<FVisualSpriteRequest> UVisualRenderer::CancelSpriteRequests(FVisualSceneBuffer& Buffer)
+{
+	if (Buffer.DrawHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(Buffer.DrawHandle);
+		Buffer.DrawHandle.Reset();
+	}
+
+	TArray<FVisualSpriteRequest> CancelledRequests = MoveTemp(Buffer.PendingSprites);
+	CancelledRequests.Append(MoveTemp(Buffer.SpritesToPlace));
+	Buffer.PendingSprites.Reset();
+	Buffer.SpritesToPlace.Reset();
+
+	return CancelledRequests;
+}
+
+void UVisualRenderer::SwapBuffers()
+{
+	check(bIsDoubleBuffered);
+	FVisualSceneBuffer& PreviousBuffer = GetFrontBuffer();
+	FrontBufferIndex = 1 - FrontBufferIndex;
+	FVisualSceneBuffer& FrontBuffer = GetFrontBuffer();
+
+	FrontBuffer.Canvas->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
+	PreviousBuffer.Canvas->SetVisibility(ESlateVisibility::Hidden);
+	INC_DWORD_STAT(STAT_SwappedSceneBuffers);
+
+	/*Hidden sprites are kept in the buffer, so that going back to the previous scene is also a swap*/
+	for (UVisualSprite* Sprite : PreviousBuffer.Sprites)
+	{
+		if (IsValid(Sprite))
 		{
-			DrawRequest.ExecuteIfBound();
-		};
+			Sprite->OnSpriteDisappear.Broadcast();
+		}
+	}
 
-		Frames = 0;
+	/*Sprites that are not placed yet appear once they are placed*/
+	TBitArray<> IsSpritePending(false, FrontBuffer.Sprites.Num());
+	auto MarkPendingSprites = [&IsSpritePending](TArray<FVisualSpriteRequest>& Requests)
+	{
+		for (FVisualSpriteRequest& Request : Requests)
+		{
+			Request.bBroadcastAppear = true;
+			IsSpritePending[Request.Index] = true;
+		}
+	};
 
-		return false;
-	}));
+	MarkPendingSprites(FrontBuffer.PendingSprites);
+	MarkPendingSprites(FrontBuffer.SpritesToPlace);
+
+	for (int32 i = 0; i < FrontBuffer.Sprites.Num(); i++)
+	{
+		if (IsValid(FrontBuffer.Sprites[i]) && !IsSpritePending[i])
+		{
+			FrontBuffer.Sprites[i]->OnSpriteAppear.Broadcast();
+		}
+	}
 }
 
 bool UVisualRenderer::IsTransitionInProgress() const
@@ -176,13 +417,7 @@ bool UVisualRenderer::TryDrawTransition(const FScenario* From, const FScenario*
 		UMaterialInstanceDynamic* DynamicTransitionMaterial = UMaterialInstanceDynamic::Create(TransitionMaterial, nullptr, TEXT("TransitionMaterial"));
 		DynamicTransitionMaterial->SetFlags(RF_Transient | RF_DuplicateTransient | RF_TextExportTransient);
 
-		ForEachSprite([this](UVisualSprite* Sprite) 
-		{
-			Canvas->RemoveChild(Sprite);
-			WidgetTree->RemoveWidget(Sprite);
-
-			Sprite->OnSpriteDisappear.Broadcast();
-		});
+		ReleaseSprites(GetFrontBuffer());
 		
 		FinalScene = To;
 		if (ToBackgroundArtInfo.bAnimate)
@@ -215,9 +450,43 @@ void UVisualRenderer::ForceStopTransition()
 TSharedRef<SWidget> UVisualRenderer::RebuildWidget()
 {
 	check(WidgetTree);
+
+	/*Sprites are children of the previous canvas*/
+	for (FVisualSceneBuffer& Buffer : SceneBuffers)
+	{
+		for (const TPair<TObjectPtr<UClass>, FVisualSpritePool>& SpritePool : Buffer.SpritePools)
+		{
+			DEC_DWORD_STAT_BY(STAT_PooledSprites, SpritePool.Value.Sprites.Num());
+		}
+
+		FTSTicker::GetCoreTicker().RemoveTicker(Buffer.DrawHandle);
+		Buffer = FVisualSceneBuffer();
+	}
+	FrontBufferIndex = 0;
+
 	Canvas = WidgetTree->ConstructWidget<UCanvasPanel>(UCanvasPanel::StaticClass(), TEXT("Canvas"));
 	WidgetTree->RootWidget = Canvas;
 
+	bIsDoubleBuffered = GetDefault<UVisualUSettings>()->bDoubleBufferedRenderer;
+	if (bIsDoubleBuffered)
+	{
+		for (int32 i = 0; i < StaticCast<int32>(UE_ARRAY_COUNT(SceneBuffers)); i++)
+		{
+			UCanvasPanel* SpriteCanvas = WidgetTree->ConstructWidget<UCanvasPanel>(UCanvasPanel::StaticClass(), *FString::Printf(TEXT("SpriteCanvas%i"), i));
+			UCanvasPanelSlot* SpriteCanvasSlot = Canvas->AddChildToCanvas(SpriteCanvas);
+			check(SpriteCanvasSlot);
+			SpriteCanvasSlot->SetAnchors(FVisualAnchors::FullScreen);
+			SpriteCanvasSlot->SetOffsets(FVisualMargin::Zero);
+			SpriteCanvas->SetVisibility(i == FrontBufferIndex ? ESlateVisibility::SelfHitTestInvisible : ESlateVisibility::Hidden);
+
+			SceneBuffers[i].Canvas = SpriteCanvas;
+		}
+	}
+	else
+	{
+		SceneBuffers[0].Canvas = Canvas;
+	}
+
 	Background = WidgetTree->ConstructWidget<UBackgroundVisualImage>(UBackgroundVisualImage::StaticClass(), TEXT("Background"));
 
 	FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float)
@@ -281,7 +550,11 @@ void UVisualRenderer::NativeOnInitialized()
 
 void UVisualRenderer::NativeDestruct()
 {
-	FTSTicker::GetCoreTicker().RemoveTicker(DrawHandle);
+	for (FVisualSceneBuffer& Buffer : SceneBuffers)
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(Buffer.DrawHandle);
+		Buffer.DrawHandle.Reset();
+	}
 
 	Super::NativeDestruct();
 }
@@ -295,17 +568,108 @@ void UVisualRenderer::OnAnimationFinished_Implementation(const UWidgetAnimation*
 		Background->StopTransition();
 		DrawScene(FinalScene);
 		FinalScene = nullptr;
+
+		if (const FScenario* Scene = DeferredPreDrawScene)
+		{
+			DeferredPreDrawScene = nullptr;
+			PreDrawScene(Scene);
+		}
 	}
 }
 
 void UVisualRenderer::ForEachSprite(TFunction<void(UVisualSprite* Sprite)> Action)
 {
-	TArray<UWidget*> Children = Canvas->GetAllChildren();
-	for (UWidget*& Child : Children)
+	/*Action might change sprites of the scene*/
+	const TArray<TObjectPtr<UVisualSprite>> Sprites = GetFrontBuffer().Sprites;
+	for (UVisualSprite* Sprite : Sprites)
 	{
-		if (UVisualSprite* Sprite = Cast<UVisualSprite>(Child))
+		if (IsValid(Sprite))
 		{
 			Action(Sprite);
 		}
 	}
 }
+
+UVisualSprite* UVisualRenderer::AcquireSprite(FVisualSceneBuffer& Buffer, UClass* SpriteClass)
+{
+	check(SpriteClass);
+	if (FVisualSpritePool* SpritePool = Buffer.SpritePools.Find(SpriteClass))
+	{
+		while (!SpritePool->Sprites.IsEmpty())
+		{
+			UVisualSprite* Sprite = SpritePool->Sprites.Pop(EAllowShrinking::No);
+			DEC_DWORD_STAT(STAT_PooledSprites);
+			if (IsValid(Sprite) && Sprite->Slot)
+			{
+				INC_DWORD_STAT(STAT_ReusedSprites);
+
+				return Sprite;
+			}
+		}
+	}
+
+	/*Several sprites of the same class might be drawn at once*/
+	const FName SpriteName = MakeUniqueObjectName(WidgetTree, SpriteClass, SpriteClass->GetFName());
+	UVisualSprite* Sprite = WidgetTree->ConstructWidget<UVisualSprite>(SpriteClass, SpriteName);
+	check(Sprite);
+
+	UCanvasPanelSlot* SpriteSlot = Buffer.Canvas->AddChildToCanvas(Sprite);
+	check(SpriteSlot);
+
+	INC_DWORD_STAT(STAT_ConstructedSprites);
+
+	return Sprite;
+}
+
+void UVisualRenderer::ReleaseSprites(FVisualSceneBuffer& Buffer)
+{
+	CancelSpriteRequests(Buffer);
+
+	TArray<TObjectPtr<UVisualSprite>> ReleasedSprites = MoveTemp(Buffer.Sprites);
+	Buffer.Sprites.Reset();
+	Buffer.SpriteData.Reset();
+	Buffer.Scene = nullptr;
+
+	for (UVisualSprite* Sprite : ReleasedSprites)
+	{
+		if (IsValid(Sprite))
+		{
+			ReleaseSprite(Buffer, Sprite);
+		}
+	}
+}
+
+void UVisualRenderer::ReleaseSprite(FVisualSceneBuffer& Buffer, UVisualSprite* Sprite)
+{
+	check(Sprite);
+	UClass* SpriteClass = Sprite->GetClass();
+	FVisualSpritePool& SpritePool = Buffer.SpritePools.FindOrAdd(SpriteClass);
+	if (SpritePool.Sprites.Num() < GetSpritePoolSize(SpriteClass))
+	{
+		Sprite->SetVisibility(ESlateVisibility::Collapsed);
+		SpritePool.Sprites.Add(Sprite);
+		INC_DWORD_STAT(STAT_PooledSprites);
+	}
+	else
+	{
+		Buffer.Canvas->RemoveChild(Sprite);
+		WidgetTree->RemoveWidget(Sprite);
+	}
+
+	/*Sprites of the hidden buffer disappeared when buffers were swapped*/
+	if (&Buffer == &GetFrontBuffer())
+	{
+		Sprite->OnSpriteDisappear.Broadcast();
+	}
+}
+
+int32 UVisualRenderer::GetSpritePoolSize(const UClass* SpriteClass) const
+{
+	const UVisualUSettings* VisualUSettings = GetDefault<UVisualUSettings>();
+	if (const int32* PoolSize = VisualUSettings->SpritePoolSizeOverrides.Find(TSoftClassPtr<UVisualSprite>(FSoftObjectPath(SpriteClass))))
+	{
+		return *PoolSize;
+	}
+
+	return VisualUSettings->SpritePoolSize;
+}
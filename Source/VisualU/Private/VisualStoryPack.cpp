@@ -0,0 +1,558 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+
+#include "VisualStoryPack.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "Scenario.h"
+#include "VisualUSettings.h"
+#include "VisualU.h"
+
+DECLARE_CYCLE_STAT(TEXT("Open Story Pack"), STAT_OpenStoryPack, STATGROUP_VisualU);
+DECLARE_CYCLE_STAT(TEXT("Create Packed Node"), STAT_CreatePackedNode, STATGROUP_VisualU);
+
+using namespace UE::VisualU::StoryPack;
+
+static_assert(std::is_trivially_copyable_v<FSceneRecord>, "Story pack records must be plain data.");
+static_assert(sizeof(FImageRecord) % 8 == 0 && sizeof(FSpriteRecord) % 8 == 0 && sizeof(FSceneRecord) % 8 == 0, "Story pack records must keep 8-byte alignment.");
+
+namespace UE::VisualU::StoryPack::Private
+{
+	template<typename T>
+	bool MapSection(const uint8* Data, int64 Size, uint32 Offset, uint32 Num, TConstArrayView<T>& OutSection)
+	{
+		if (Offset % alignof(T) != 0 || static_cast<int64>(Offset) + static_cast<int64>(Num) * sizeof(T) > Size)
+		{
+			return false;
+		}
+
+		OutSection = MakeArrayView(reinterpret_cast<const T*>(Data + Offset), Num);
+		return true;
+	}
+
+	FORCEINLINE bool IsValidRange(uint32 First, uint32 Num, int32 Max)
+	{
+		return static_cast<int64>(First) + Num <= Max;
+	}
+}
+
+FVisualStoryPack::FVisualStoryPack()
+	: MappedHandle(),
+	MappedRegion(),
+	Buffer(),
+	Data(nullptr),
+	Size(0),
+	Strings(),
+	StringData(),
+	Paths(),
+	Nodes(),
+	Scenes(),
+	Sprites(),
+	Images(),
+	ChoiceTargets(),
+	NodeIndices()
+{
+}
+
+FVisualStoryPack::~FVisualStoryPack()
+{
+	/*Region must be unmapped before its file is closed*/
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+}
+
+FVisualStoryPack* FVisualStoryPack::Get()
+{
+	check(IsInGameThread());
+	static TUniquePtr<FVisualStoryPack> StoryPack = []() -> TUniquePtr<FVisualStoryPack>
+	{
+		const UVisualUSettings* VisualUSettings = GetDefault<UVisualUSettings>();
+		if (GIsEditor || !VisualUSettings->bUseStoryPack)
+		{
+			return nullptr;
+		}
+
+		return Open(FPaths::ProjectContentDir() / VisualUSettings->StoryPackPath);
+	}();
+
+	return StoryPack.Get();
+}
+
+TUniquePtr<FVisualStoryPack> FVisualStoryPack::Open(const FString& Filename)
+{
+	SCOPE_CYCLE_COUNTER(STAT_OpenStoryPack);
+	TUniquePtr<FVisualStoryPack> StoryPack(new FVisualStoryPack());
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	FOpenMappedResult MappedResult = PlatformFile.OpenMappedEx(*Filename);
+	if (MappedResult.HasValue())
+	{
+		StoryPack->MappedHandle = MappedResult.StealValue();
+		StoryPack->MappedRegion.Reset(StoryPack->MappedHandle->MapRegion(0, StoryPack->MappedHandle->GetFileSize()));
+	}
+
+	if (StoryPack->MappedRegion.IsValid())
+	{
+		StoryPack->Data = StoryPack->MappedRegion->GetMappedPtr();
+		StoryPack->Size = StoryPack->MappedRegion->GetMappedSize();
+	}
+	else if (FFileHelper::LoadFileToArray(StoryPack->Buffer, *Filename, FILEREAD_Silent))
+	{
+		StoryPack->Data = StoryPack->Buffer.GetData();
+		StoryPack->Size = StoryPack->Buffer.Num();
+	}
+	else
+	{
+		UE_LOG(LogVisualU, Warning, TEXT("Unable to open story pack %s, data tables will be used instead."), *Filename);
+		return nullptr;
+	}
+
+	if (!StoryPack->Validate())
+	{
+		UE_LOG(LogVisualU, Warning, TEXT("Story pack %s is outdated or corrupted, data tables will be used instead."), *Filename);
+		return nullptr;
+	}
+
+	StoryPack->NodeIndices.Reserve(StoryPack->Nodes.Num());
+	for (int32 i = 0; i < StoryPack->Nodes.Num(); i++)
+	{
+		StoryPack->NodeIndices.Add(StoryPack->GetPath(StoryPack->Nodes[i].Path), i);
+	}
+
+	return StoryPack;
+}
+
+UDataTable* FVisualStoryPack::LoadNode(const FSoftObjectPath& Path)
+{
+	if (Path.IsNull())
+	{
+		return nullptr;
+	}
+
+	if (UDataTable* Node = Cast<UDataTable>(Path.ResolveObject()))
+	{
+		return Node;
+	}
+
+	if (const FVisualStoryPack* StoryPack = Get())
+	{
+		if (UDataTable* Node = StoryPack->FindOrCreateNode(Path))
+		{
+			return Node;
+		}
+	}
+
+	return Cast<UDataTable>(Path.TryLoad());
+}
+
+bool FVisualStoryPack::Contains(const FSoftObjectPath& Path) const
+{
+	return NodeIndices.Contains(Path);
+}
+
+UDataTable* FVisualStoryPack::FindOrCreateNode(const FSoftObjectPath& Path) const
+{
+	const int32* NodeIndex = NodeIndices.Find(Path);
+	if (!NodeIndex)
+	{
+		return nullptr;
+	}
+
+	if (UDataTable* Node = Cast<UDataTable>(Path.ResolveObject()))
+	{
+		return Node;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_CreatePackedNode);
+	UPackage* Package = CreatePackage(*Path.GetLongPackageName());
+	UVisualStoryPackTable* Node = NewObject<UVisualStoryPackTable>(Package, FName(Path.GetAssetName()), RF_Public | RF_Standalone | RF_Transient);
+	Node->RowStruct = FScenario::StaticStruct();
+
+	const FNodeRecord& NodeRecord = Nodes[*NodeIndex];
+	UScriptStruct* RowStruct = Node->RowStruct;
+	for (uint32 i = NodeRecord.FirstScene; i < NodeRecord.FirstScene + NodeRecord.NumScenes; i++)
+	{
+		uint8* RowData = static_cast<uint8*>(FMemory::Malloc(RowStruct->GetStructureSize(), RowStruct->GetMinAlignment()));
+		RowStruct->InitializeStruct(RowData);
+		ReadScene(Scenes[i], *reinterpret_cast<FScenario*>(RowData));
+		Node->AddRowInternal(FName(GetString(Scenes[i].RowName)), RowData);
+	}
+
+	/*Node must not be loaded again from its package*/
+	Package->MarkAsFullyLoaded();
+
+	/*Assigns owner and index to the scenes*/
+	Node->HandleDataTableChanged();
+
+	return Node;
+}
+
+bool FVisualStoryPack::Validate()
+{
+	using namespace UE::VisualU::StoryPack::Private;
+
+	if (!Data || Size < static_cast<int64>(sizeof(FHeader)) || Size > MAX_uint32)
+	{
+		return false;
+	}
+
+	const FHeader& Header = *reinterpret_cast<const FHeader*>(Data);
+	if (Header.Magic != Magic || Header.Version != Version)
+	{
+		return false;
+	}
+
+	if (!MapSection(Data, Size, Header.StringsOffset, Header.NumStrings, Strings)
+		|| !MapSection(Data, Size, Header.StringDataOffset, Header.StringDataSize, StringData)
+		|| !MapSection(Data, Size, Header.PathsOffset, Header.NumPaths, Paths)
+		|| !MapSection(Data, Size, Header.NodesOffset, Header.NumNodes, Nodes)
+		|| !MapSection(Data, Size, Header.ScenesOffset, Header.NumScenes, Scenes)
+		|| !MapSection(Data, Size, Header.SpritesOffset, Header.NumSprites, Sprites)
+		|| !MapSection(Data, Size, Header.ImagesOffset, Header.NumImages, Images)
+		|| !MapSection(Data, Size, Header.ChoiceTargetsOffset, Header.NumChoiceTargets, ChoiceTargets))
+	{
+		return false;
+	}
+
+	const auto IsValidString = [this](uint32 StringIndex) { return StringIndex == None || Strings.IsValidIndex(StringIndex); };
+	const auto IsValidPath = [this](uint32 PathIndex) { return PathIndex == None || Paths.IsValidIndex(PathIndex); };
+	const auto IsValidText = [&IsValidString](const FTextRecord& Text) { return IsValidString(Text.Namespace) && IsValidString(Text.Key) && IsValidString(Text.Source); };
+
+	for (const FStringRecord& String : Strings)
+	{
+		if (!IsValidRange(String.Offset, String.Length, StringData.Num()))
+		{
+			return false;
+		}
+	}
+
+	for (const uint32 Path : Paths)
+	{
+		if (!Strings.IsValidIndex(Path))
+		{
+			return false;
+		}
+	}
+
+	for (const FNodeRecord& Node : Nodes)
+	{
+		if (!Paths.IsValidIndex(Node.Path) || !IsValidRange(Node.FirstScene, Node.NumScenes, Scenes.Num()))
+		{
+			return false;
+		}
+	}
+
+	for (const FSceneRecord& Scene : Scenes)
+	{
+		if (!Strings.IsValidIndex(Scene.RowName)
+			|| !IsValidText(Scene.Author)
+			|| !IsValidText(Scene.Line)
+			|| !IsValidPath(Scene.Sound)
+			|| !IsValidPath(Scene.TransitionMaterial)
+			|| !IsValidPath(Scene.BackgroundArt.Expression)
+			|| !IsValidRange(Scene.FirstSprite, Scene.NumSprites, Sprites.Num())
+			|| !IsValidRange(Scene.FirstChoiceTarget, Scene.NumChoiceTargets, ChoiceTargets.Num()))
+		{
+			return false;
+		}
+	}
+
+	for (const FSpriteRecord& Sprite : Sprites)
+	{
+		if (!IsValidPath(Sprite.SpriteClass) || !IsValidRange(Sprite.FirstImage, Sprite.NumImages, Images.Num()))
+		{
+			return false;
+		}
+	}
+
+	for (const FImageRecord& Image : Images)
+	{
+		if (!IsValidPath(Image.Expression))
+		{
+			return false;
+		}
+	}
+
+	for (const uint32 ChoiceTarget : ChoiceTargets)
+	{
+		if (!IsValidPath(ChoiceTarget))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+FString FVisualStoryPack::GetString(uint32 StringIndex) const
+{
+	if (StringIndex == None)
+	{
+		return FString();
+	}
+
+	const FStringRecord& String = Strings[StringIndex];
+	const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(StringData.GetData() + String.Offset), String.Length);
+
+	return FString::ConstructFromPtrSize(Converted.Get(), Converted.Length());
+}
+
+FSoftObjectPath FVisualStoryPack::GetPath(uint32 PathIndex) const
+{
+	return PathIndex == None ? FSoftObjectPath() : FSoftObjectPath(GetString(Paths[PathIndex]));
+}
+
+FText FVisualStoryPack::GetText(const FTextRecord& Record) const
+{
+	if (Record.Source == None)
+	{
+		return FText::GetEmpty();
+	}
+
+	FString Source = GetString(Record.Source);
+	if (Record.Key == None)
+	{
+		return FText::AsCultureInvariant(MoveTemp(Source));
+	}
+
+	/*Localized through the same namespace and key as the original text*/
+	return FText::AsLocalizable_Advanced(GetString(Record.Namespace), GetString(Record.Key), MoveTemp(Source));
+}
+
+void FVisualStoryPack::ReadImage(const FImageRecord& Record, FVisualImageInfo& OutImageInfo) const
+{
+	OutImageInfo.Expression = TSoftObjectPtr<UPaperFlipbook>(GetPath(Record.Expression));
+	OutImageInfo.ColorAndOpacity = FLinearColor(Record.ColorAndOpacity[0], Record.ColorAndOpacity[1], Record.ColorAndOpacity[2], Record.ColorAndOpacity[3]);
+	OutImageInfo.DesiredScale = FVector2D(Record.DesiredScale[0], Record.DesiredScale[1]);
+	OutImageInfo.MirrorScale = FVector2D(Record.MirrorScale[0], Record.MirrorScale[1]);
+	OutImageInfo.bAnimate = Record.bAnimate != 0;
+	OutImageInfo.FrameIndex = Record.FrameIndex;
+}
+
+void FVisualStoryPack::ReadScene(const FSceneRecord& Record, FScenario& OutScene) const
+{
+	FVisualScenarioInfo& Info = OutScene.Info;
+	Info.Author = GetText(Record.Author);
+	Info.Line = GetText(Record.Line);
+	Info.Sound = TSoftObjectPtr<USoundBase>(GetPath(Record.Sound));
+	ReadImage(Record.BackgroundArt, Info.Background.BackgroundArtInfo);
+	Info.Background.TransitionMaterial = TSoftObjectPtr<UMaterialInterface>(GetPath(Record.TransitionMaterial));
+	Info.Flags = Record.Flags;
+
+	Info.SpritesParams.SetNum(Record.NumSprites);
+	for (uint32 i = 0; i < Record.NumSprites; i++)
+	{
+		const FSpriteRecord& SpriteRecord = Sprites[Record.FirstSprite + i];
+		FSprite& Sprite = Info.SpritesParams[i];
+		Sprite.SpriteClass = TSoftClassPtr<UVisualSprite>(GetPath(SpriteRecord.SpriteClass));
+		Sprite.Anchors.Minimum = FVector2D(SpriteRecord.Anchors[0], SpriteRecord.Anchors[1]);
+		Sprite.Anchors.Maximum = FVector2D(SpriteRecord.Anchors[2], SpriteRecord.Anchors[3]);
+		Sprite.Position = FVector2D(SpriteRecord.Position[0], SpriteRecord.Position[1]);
+		Sprite.ZOrder = SpriteRecord.ZOrder;
+
+		Sprite.SpriteInfo.SetNum(SpriteRecord.NumImages);
+		for (uint32 j = 0; j < SpriteRecord.NumImages; j++)
+		{
+			ReadImage(Images[SpriteRecord.FirstImage + j], Sprite.SpriteInfo[j]);
+		}
+	}
+
+	OutScene.ChoiceTargets.SetNum(Record.NumChoiceTargets);
+	for (uint32 i = 0; i < Record.NumChoiceTargets; i++)
+	{
+		OutScene.ChoiceTargets[i] = TSoftObjectPtr<UDataTable>(GetPath(ChoiceTargets[Record.FirstChoiceTarget + i]));
+	}
+}
+
+#if WITH_EDITOR
+int32 FVisualStoryPack::Write(TConstArrayView<const UDataTable*> InNodes, TArray<uint8>& OutData)
+{
+	TArray<FStringRecord> StringRecords;
+	TArray<uint8> StringData;
+	TMap<FString, uint32> StringIndices;
+	TArray<uint32> PathRecords;
+	TMap<FString, uint32> PathIndices;
+	TArray<FNodeRecord> NodeRecords;
+	TArray<FSceneRecord> SceneRecords;
+	TArray<FSpriteRecord> SpriteRecords;
+	TArray<FImageRecord> ImageRecords;
+	TArray<uint32> ChoiceTargetRecords;
+
+	const auto AddString = [&](const FString& String) -> uint32
+	{
+		if (const uint32* StringIndex = StringIndices.Find(String))
+		{
+			return *StringIndex;
+		}
+
+		const FTCHARToUTF8 Converted(*String);
+		const uint32 StringIndex = StringRecords.Add(FStringRecord{ static_cast<uint32>(StringData.Num()), static_cast<uint32>(Converted.Length()) });
+		StringData.Append(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+		StringIndices.Add(String, StringIndex);
+
+		return StringIndex;
+	};
+
+	const auto AddPath = [&](const FSoftObjectPath& Path) -> uint32
+	{
+		if (Path.IsNull())
+		{
+			return None;
+		}
+
+		const FString PathString = Path.ToString();
+		if (const uint32* PathIndex = PathIndices.Find(PathString))
+		{
+			return *PathIndex;
+		}
+
+		const uint32 PathIndex = PathRecords.Add(AddString(PathString));
+		PathIndices.Add(PathString, PathIndex);
+
+		return PathIndex;
+	};
+
+	const auto MakeText = [&](const FText& Text) -> FTextRecord
+	{
+		FTextRecord Record{ None, None, None };
+		if (Text.IsEmpty())
+		{
+			return Record;
+		}
+
+		const FString* Source = FTextInspector::GetSourceString(Text);
+		Record.Source = AddString(Source ? *Source : Text.ToString());
+
+		const TOptional<FString> Key = FTextInspector::GetKey(Text);
+		if (!Text.IsCultureInvariant() && Key.IsSet())
+		{
+			Record.Namespace = AddString(FTextInspector::GetNamespace(Text).Get(FString()));
+			Record.Key = AddString(Key.GetValue());
+		}
+
+		return Record;
+	};
+
+	const auto MakeImage = [&](const FVisualImageInfo& ImageInfo) -> FImageRecord
+	{
+		FImageRecord Record;
+		FMemory::Memzero(Record);
+		Record.DesiredScale[0] = ImageInfo.DesiredScale.X;
+		Record.DesiredScale[1] = ImageInfo.DesiredScale.Y;
+		Record.MirrorScale[0] = ImageInfo.MirrorScale.X;
+		Record.MirrorScale[1] = ImageInfo.MirrorScale.Y;
+		Record.ColorAndOpacity[0] = ImageInfo.ColorAndOpacity.R;
+		Record.ColorAndOpacity[1] = ImageInfo.ColorAndOpacity.G;
+		Record.ColorAndOpacity[2] = ImageInfo.ColorAndOpacity.B;
+		Record.ColorAndOpacity[3] = ImageInfo.ColorAndOpacity.A;
+		Record.Expression = AddPath(ImageInfo.Expression.ToSoftObjectPath());
+		Record.FrameIndex = ImageInfo.FrameIndex;
+		Record.bAnimate = ImageInfo.bAnimate ? 1 : 0;
+
+		return Record;
+	};
+
+	for (const UDataTable* Node : InNodes)
+	{
+		/*Extended scenes carry data the pack does not describe*/
+		if (!Node || Node->GetRowStruct() != FScenario::StaticStruct())
+		{
+			continue;
+		}
+
+		FNodeRecord& NodeRecord = NodeRecords.AddDefaulted_GetRef();
+		NodeRecord.Path = AddPath(FSoftObjectPath(Node));
+		NodeRecord.FirstScene = SceneRecords.Num();
+		NodeRecord.NumScenes = Node->GetRowMap().Num();
+
+		for (const TPair<FName, uint8*>& Row : Node->GetRowMap())
+		{
+			const FScenario& Scene = *reinterpret_cast<const FScenario*>(Row.Value);
+			const FVisualScenarioInfo& Info = Scene.Info;
+
+			FSceneRecord SceneRecord;
+			FMemory::Memzero(SceneRecord);
+			SceneRecord.BackgroundArt = MakeImage(Info.Background.BackgroundArtInfo);
+			SceneRecord.Author = MakeText(Info.Author);
+			SceneRecord.Line = MakeText(Info.Line);
+			SceneRecord.RowName = AddString(Row.Key.ToString());
+			SceneRecord.Sound = AddPath(Info.Sound.ToSoftObjectPath());
+			SceneRecord.TransitionMaterial = AddPath(Info.Background.TransitionMaterial.ToSoftObjectPath());
+			SceneRecord.Flags = Info.Flags;
+
+			SceneRecord.FirstSprite = SpriteRecords.Num();
+			SceneRecord.NumSprites = Info.SpritesParams.Num();
+			for (const FSprite& Sprite : Info.SpritesParams)
+			{
+				FSpriteRecord SpriteRecord;
+				FMemory::Memzero(SpriteRecord);
+				SpriteRecord.Anchors[0] = Sprite.Anchors.Minimum.X;
+				SpriteRecord.Anchors[1] = Sprite.Anchors.Minimum.Y;
+				SpriteRecord.Anchors[2] = Sprite.Anchors.Maximum.X;
+				SpriteRecord.Anchors[3] = Sprite.Anchors.Maximum.Y;
+				SpriteRecord.Position[0] = Sprite.Position.X;
+				SpriteRecord.Position[1] = Sprite.Position.Y;
+				SpriteRecord.ZOrder = Sprite.ZOrder;
+				SpriteRecord.SpriteClass = AddPath(Sprite.SpriteClass.ToSoftObjectPath());
+				SpriteRecord.FirstImage = ImageRecords.Num();
+				SpriteRecord.NumImages = Sprite.SpriteInfo.Num();
+				for (const FVisualImageInfo& ImageInfo : Sprite.SpriteInfo)
+				{
+					ImageRecords.Add(MakeImage(ImageInfo));
+				}
+
+				SpriteRecords.Add(SpriteRecord);
+			}
+
+			SceneRecord.FirstChoiceTarget = ChoiceTargetRecords.Num();
+			SceneRecord.NumChoiceTargets = Scene.ChoiceTargets.Num();
+			for (const TSoftObjectPtr<UDataTable>& ChoiceTarget : Scene.ChoiceTargets)
+			{
+				ChoiceTargetRecords.Add(AddPath(ChoiceTarget.ToSoftObjectPath()));
+			}
+
+			SceneRecords.Add(SceneRecord);
+		}
+	}
+
+	const auto AppendSection = [&OutData](const void* SectionData, int64 SectionSize) -> uint32
+	{
+		OutData.AddZeroed(Align(OutData.Num(), 8) - OutData.Num());
+		const uint32 Offset = OutData.Num();
+		OutData.Append(static_cast<const uint8*>(SectionData), SectionSize);
+
+		return Offset;
+	};
+
+	FHeader Header;
+	FMemory::Memzero(Header);
+	OutData.Reset();
+	OutData.AddZeroed(sizeof(FHeader));
+
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.NumStrings = StringRecords.Num();
+	Header.StringsOffset = AppendSection(StringRecords.GetData(), StringRecords.NumBytes());
+	Header.StringDataSize = StringData.Num();
+	Header.StringDataOffset = AppendSection(StringData.GetData(), StringData.NumBytes());
+	Header.NumPaths = PathRecords.Num();
+	Header.PathsOffset = AppendSection(PathRecords.GetData(), PathRecords.NumBytes());
+	Header.NumNodes = NodeRecords.Num();
+	Header.NodesOffset = AppendSection(NodeRecords.GetData(), NodeRecords.NumBytes());
+	Header.NumScenes = SceneRecords.Num();
+	Header.ScenesOffset = AppendSection(SceneRecords.GetData(), SceneRecords.NumBytes());
+	Header.NumSprites = SpriteRecords.Num();
+	Header.SpritesOffset = AppendSection(SpriteRecords.GetData(), SpriteRecords.NumBytes());
+	Header.NumImages = ImageRecords.Num();
+	Header.ImagesOffset = AppendSection(ImageRecords.GetData(), ImageRecords.NumBytes());
+	Header.NumChoiceTargets = ChoiceTargetRecords.Num();
+	Header.ChoiceTargetsOffset = AppendSection(ChoiceTargetRecords.GetData(), ChoiceTargetRecords.NumBytes());
+
+	FMemory::Memcpy(OutData.GetData(), &Header, sizeof(FHeader));
+
+	return NodeRecords.Num();
+}
+#endif
@@ -55,6 +55,7 @@ void UVisualTextBlock::Typewrite()
 	{
 		bHasFinishedPlaying = true;
 		OnTypewriterFinished();
+		OnTypewriterEnd.Broadcast();
 
 		SetVisibility(ESlateVisibility::Hidden);
 	}
@@ -108,6 +109,7 @@ void UVisualTextBlock::ForceTypewriteToEnd()
 
 	bHasFinishedPlaying = true;
 	OnTypewriterFinished();
+	OnTypewriterEnd.Broadcast();
 }
 
 TSharedRef<SWidget> UVisualTextBlock::RebuildWidget()
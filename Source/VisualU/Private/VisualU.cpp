@@ -15,6 +15,8 @@
 
 #define LOCTEXT_NAMESPACE "VisualU"
 DEFINE_LOG_CATEGORY(LogVisualU);
+DEFINE_STAT(STAT_PaintVisualImages);
+DEFINE_STAT(STAT_VisualImageBrushBuilds);
 
 void FVisualUModule::StartupModule()
 {
@@ -18,6 +18,132 @@
 #include "Serialization/MemoryWriter.h"
 #include "Serialization/MemoryReader.h"
 #include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "Serialization/CustomVersion.h"
+#include "VisualUCustomVersion.h"
+#include "VisualUSaveArchive.h"
+#include "Misc/Compression.h"
+#include "Tasks/Task.h"
+#include "Async/Async.h"
+
+DECLARE_CYCLE_STAT(TEXT("Save VisualU"), STAT_SaveVisualU, STATGROUP_VisualU);
+DECLARE_CYCLE_STAT(TEXT("Load VisualU"), STAT_LoadVisualU, STATGROUP_VisualU);
+DECLARE_MEMORY_STAT(TEXT("Last Save Size"), STAT_LastSaveSize, STATGROUP_VisualU);
+DECLARE_CYCLE_STAT(TEXT("Compress VisualU Save"), STAT_CompressVisualUSave, STATGROUP_VisualU);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Coalesced Saves"), STAT_CoalescedSaves, STATGROUP_VisualU);
+
+namespace UE::VisualU::Private
+{
+	/*"VISU", legacy saves start with tagged properties of the versioning subsystem written by UObject::Serialize instead*/
+	constexpr uint32 SaveMagic = 0x55534956;
+
+	/*"VISZ", compressed save is prefixed with it and the uncompressed size*/
+	constexpr uint32 CompressedSaveMagic = 0x5A534956;
+
+	constexpr int32 CompressedSaveHeaderSize = sizeof(uint32) + sizeof(int32);
+
+	/**
+	* Save or load request processed off the game thread.
+	*/
+	struct FSaveOperation
+	{
+		bool bIsSave = true;
+
+		FString Filename;
+
+		FPlatformUserId UserId;
+
+		/*Snapshot of the state to write*/
+		TArray<uint8> Data;
+
+		/*Callbacks of the coalesced saves*/
+		TArray<FOnVisualUSaved, TInlineAllocator<1>> OnSaved;
+
+		FOnVisualULoaded OnLoaded;
+
+		TWeakObjectPtr<UVisualVersioningSubsystem> VersioningSubsystem;
+
+		TWeakObjectPtr<UVisualController> VisualController;
+	};
+
+	/**
+	* Operations are processed one at a time, in the order of requests,
+	* so that load observes saves requested before it. Game thread only.
+	*/
+	struct FSaveQueue
+	{
+		/*First operation is in flight when bInFlight is set*/
+		TArray<FSaveOperation> Operations;
+
+		bool bInFlight = false;
+	};
+
+	FSaveQueue& GetSaveQueue()
+	{
+		static FSaveQueue SaveQueue;
+		return SaveQueue;
+	}
+
+	bool CompressSave(const TArray<uint8>& Data, TArray<uint8>& OutCompressed)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CompressVisualUSave);
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Data.Num());
+		OutCompressed.SetNumUninitialized(CompressedSaveHeaderSize + CompressedSize);
+
+		if (!FCompression::CompressMemory(NAME_Zlib, OutCompressed.GetData() + CompressedSaveHeaderSize, CompressedSize, Data.GetData(), Data.Num()))
+		{
+			return false;
+		}
+
+		OutCompressed.SetNum(CompressedSaveHeaderSize + CompressedSize);
+
+		uint32 Magic = CompressedSaveMagic;
+		int32 UncompressedSize = Data.Num();
+		FMemoryWriter HeaderWriter(OutCompressed);
+		HeaderWriter << Magic;
+		HeaderWriter << UncompressedSize;
+
+		return true;
+	}
+
+	/**
+	* Decompresses data in place, uncompressed data is left as is.
+	*
+	* @return whether or not data is readable
+	*/
+	bool DecompressSave(TArray<uint8>& Data)
+	{
+		if (Data.Num() < CompressedSaveHeaderSize)
+		{
+			return true;
+		}
+
+		uint32 Magic = 0;
+		int32 UncompressedSize = 0;
+		FMemoryReader HeaderReader(Data);
+		HeaderReader << Magic;
+		if (Magic != CompressedSaveMagic)
+		{
+			return true;
+		}
+
+		HeaderReader << UncompressedSize;
+		if (UncompressedSize < 0)
+		{
+			return false;
+		}
+
+		TArray<uint8> Uncompressed;
+		Uncompressed.SetNumUninitialized(UncompressedSize);
+		if (!FCompression::UncompressMemory(NAME_Zlib, Uncompressed.GetData(), UncompressedSize, Data.GetData() + CompressedSaveHeaderSize, Data.Num() - CompressedSaveHeaderSize))
+		{
+			return false;
+		}
+
+		Data = MoveTemp(Uncompressed);
+
+		return true;
+	}
+}
 
 UTexture2D* UVisualUBlueprintStatics::GetSpriteTexture(UPaperSprite* Sprite)
 {
@@ -78,10 +204,8 @@ bool UVisualUBlueprintStatics::LoadVisualU(UVisualVersioningSubsystem* Versionin
 		UserId,
 		Data))
 	{
-		FMemoryReader MemoryReader = FMemoryReader(Data);
-		SerializeVisualU(MemoryReader, VersioningSubsystem, VisualController);
-
-		return true;
+		SCOPE_CYCLE_COUNTER(STAT_LoadVisualU);
+		return ReadVisualU(Data, VersioningSubsystem, VisualController);
 	}
 
 	return false;
@@ -96,17 +220,109 @@ bool UVisualUBlueprintStatics::SaveVisualU(UVisualVersioningSubsystem* Versionin
 
 	FPlatformUserId UserId = FPlatformMisc::GetPlatformUserForUserIndex(UserIndex);
 
+	check(VisualController);
+	if (!VisualController->CanSave())
+	{
+		UE_LOG(LogVisualU, Warning, TEXT("Visual Controller is not initialized yet, VisualU is not saved to %s."), *Filename);
+		return false;
+	}
+
 	TArray<uint8> Data;
-	FMemoryWriter MemoryWriter = FMemoryWriter(Data);
-	SerializeVisualU(MemoryWriter, VersioningSubsystem, VisualController);
-	FPlatformMisc::GetPlatformUserForUserIndex(UserIndex);
+	{
+		SCOPE_CYCLE_COUNTER(STAT_SaveVisualU);
+		const double SaveStartTime = FPlatformTime::Seconds();
+
+		FMemoryWriter MemoryWriter = FMemoryWriter(Data);
+		SerializeVisualU(MemoryWriter, VersioningSubsystem, VisualController);
+
+		SET_MEMORY_STAT(STAT_LastSaveSize, Data.Num());
+		UE_LOG(LogVisualU, Verbose, TEXT("VisualU saved to %s: %i bytes in %.2f ms."), *Filename, Data.Num(), (FPlatformTime::Seconds() - SaveStartTime) * 1000.0);
+	}
+
+	/*Same format as the asynchronous save*/
+	TArray<uint8> CompressedData;
+	if (!UE::VisualU::Private::CompressSave(Data, CompressedData))
+	{
+		UE_LOG(LogVisualU, Warning, TEXT("Failed to compress VisualU save, VisualU is not saved to %s."), *Filename);
+		return false;
+	}
 
 	const bool bAttemptToUseNativeUI = true;
 	return SaveGameSystem->SaveGame(
 		bAttemptToUseNativeUI,
 		*Filename,
 		UserId,
-		Data);
+		CompressedData);
+}
+
+void UVisualUBlueprintStatics::SaveVisualUAsync(UVisualVersioningSubsystem* VersioningSubsystem, UVisualController* VisualController, int32 UserIndex, const FString& Filename, FOnVisualUSaved OnSaved)
+{
+	check(IsInGameThread());
+	check(!Filename.IsEmpty());
+	using namespace UE::VisualU::Private;
+
+	check(VisualController);
+	if (!VisualController->CanSave())
+	{
+		UE_LOG(LogVisualU, Warning, TEXT("Visual Controller is not initialized yet, VisualU is not saved to %s."), *Filename);
+		OnSaved.ExecuteIfBound(false);
+		return;
+	}
+
+	TArray<uint8> Data;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_SaveVisualU);
+		FMemoryWriter MemoryWriter = FMemoryWriter(Data);
+		SerializeVisualU(MemoryWriter, VersioningSubsystem, VisualController);
+
+		SET_MEMORY_STAT(STAT_LastSaveSize, Data.Num());
+	}
+
+	const FPlatformUserId UserId = FPlatformMisc::GetPlatformUserForUserIndex(UserIndex);
+	FSaveQueue& SaveQueue = GetSaveQueue();
+
+	/*Queued save of the same file is superseded by the newer snapshot*/
+	const int32 NumInFlight = SaveQueue.bInFlight ? 1 : 0;
+	if (SaveQueue.Operations.Num() > NumInFlight)
+	{
+		FSaveOperation& LastOperation = SaveQueue.Operations.Last();
+		if (LastOperation.bIsSave && LastOperation.UserId == UserId && LastOperation.Filename == Filename)
+		{
+			LastOperation.Data = MoveTemp(Data);
+			LastOperation.OnSaved.Add(OnSaved);
+			INC_DWORD_STAT(STAT_CoalescedSaves);
+
+			return;
+		}
+	}
+
+	FSaveOperation& Operation = SaveQueue.Operations.AddDefaulted_GetRef();
+	Operation.bIsSave = true;
+	Operation.Filename = Filename;
+	Operation.UserId = UserId;
+	Operation.Data = MoveTemp(Data);
+	Operation.OnSaved.Add(OnSaved);
+
+	ProcessSaveQueue();
+}
+
+void UVisualUBlueprintStatics::LoadVisualUAsync(UVisualVersioningSubsystem* VersioningSubsystem, UVisualController* VisualController, int32 UserIndex, const FString& Filename, FOnVisualULoaded OnLoaded)
+{
+	check(IsInGameThread());
+	check(!Filename.IsEmpty());
+	check(VersioningSubsystem);
+	check(VisualController);
+	using namespace UE::VisualU::Private;
+
+	FSaveOperation& Operation = GetSaveQueue().Operations.AddDefaulted_GetRef();
+	Operation.bIsSave = false;
+	Operation.Filename = Filename;
+	Operation.UserId = FPlatformMisc::GetPlatformUserForUserIndex(UserIndex);
+	Operation.OnLoaded = OnLoaded;
+	Operation.VersioningSubsystem = VersioningSubsystem;
+	Operation.VisualController = VisualController;
+
+	ProcessSaveQueue();
 }
 
 bool UVisualUBlueprintStatics::Choose(UVisualController* Controller, const UDataTable* DataTable)
@@ -137,12 +353,167 @@ void UVisualUBlueprintStatics::GetScenesData(TArray<FAssetData>& OutData)
 	}
 }
 
+bool UVisualUBlueprintStatics::ReadVisualU(TArray<uint8>& Data, UVisualVersioningSubsystem* VersioningSubsystem, UVisualController* VisualController)
+{
+	if (!UE::VisualU::Private::DecompressSave(Data))
+	{
+		UE_LOG(LogVisualU, Error, TEXT("Failed to decompress VisualU save."));
+		return false;
+	}
+
+	FMemoryReader MemoryReader = FMemoryReader(Data);
+	SerializeVisualU(MemoryReader, VersioningSubsystem, VisualController);
+
+	return !MemoryReader.IsError();
+}
+
+void UVisualUBlueprintStatics::ProcessSaveQueue()
+{
+	using namespace UE::VisualU::Private;
+
+	FSaveQueue& SaveQueue = GetSaveQueue();
+	if (SaveQueue.bInFlight || SaveQueue.Operations.IsEmpty())
+	{
+		return;
+	}
+
+	ISaveGameSystem* SaveGameSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	check(SaveGameSystem);
+
+	SaveQueue.bInFlight = true;
+	FSaveOperation& Operation = SaveQueue.Operations[0];
+
+	/*Native UI is not available off the game thread*/
+	const bool bAttemptToUseNativeUI = false;
+	if (Operation.bIsSave)
+	{
+		UE::Tasks::Launch(UE_SOURCE_LOCATION, [SaveGameSystem, Filename = Operation.Filename, UserId = Operation.UserId, Data = MoveTemp(Operation.Data)]()
+		{
+			TArray<uint8> CompressedData;
+			const bool bSaved = CompressSave(Data, CompressedData)
+				&& SaveGameSystem->SaveGame(bAttemptToUseNativeUI, *Filename, UserId, CompressedData);
+
+			AsyncTask(ENamedThreads::GameThread, [bSaved]()
+			{
+				CompleteSaveOperation(bSaved, TArray<uint8>());
+			});
+		});
+	}
+	else
+	{
+		UE::Tasks::Launch(UE_SOURCE_LOCATION, [SaveGameSystem, Filename = Operation.Filename, UserId = Operation.UserId]()
+		{
+			TArray<uint8> Data;
+			const bool bLoaded = SaveGameSystem->LoadGame(bAttemptToUseNativeUI, *Filename, UserId, Data)
+				&& DecompressSave(Data);
+
+			AsyncTask(ENamedThreads::GameThread, [bLoaded, Data = MoveTemp(Data)]() mutable
+			{
+				CompleteSaveOperation(bLoaded, MoveTemp(Data));
+			});
+		});
+	}
+}
+
+void UVisualUBlueprintStatics::CompleteSaveOperation(bool bSuccess, TArray<uint8>&& LoadedData)
+{
+	using namespace UE::VisualU::Private;
+
+	FSaveQueue& SaveQueue = GetSaveQueue();
+	check(SaveQueue.bInFlight && !SaveQueue.Operations.IsEmpty());
+
+	FSaveOperation Operation = MoveTemp(SaveQueue.Operations[0]);
+	SaveQueue.Operations.RemoveAt(0);
+	SaveQueue.bInFlight = false;
+
+	if (Operation.bIsSave)
+	{
+		UE_CLOG(!bSuccess, LogVisualU, Warning, TEXT("Failed to save VisualU to %s."), *Operation.Filename);
+		for (const FOnVisualUSaved& OnSaved : Operation.OnSaved)
+		{
+			OnSaved.ExecuteIfBound(bSuccess);
+		}
+	}
+	else
+	{
+		UVisualController* VisualController = Operation.VisualController.Get();
+		bool bLoaded = bSuccess && Operation.VersioningSubsystem.IsValid() && VisualController;
+		if (bLoaded)
+		{
+			SCOPE_CYCLE_COUNTER(STAT_LoadVisualU);
+			bLoaded = ReadVisualU(LoadedData, Operation.VersioningSubsystem.Get(), VisualController);
+		}
+
+		if (bLoaded && VisualController->IsLoadingSavedScenes())
+		{
+			/*Loaded state is applied once nodes of the saved scenes are loaded*/
+			TSharedRef<FDelegateHandle> LoadedHandle = MakeShared<FDelegateHandle>();
+			*LoadedHandle = VisualController->OnSavedScenesLoaded.AddWeakLambda(VisualController, [VisualController, LoadedHandle, OnLoaded = Operation.OnLoaded]()
+			{
+				VisualController->OnSavedScenesLoaded.Remove(*LoadedHandle);
+				OnLoaded.ExecuteIfBound(true);
+			});
+		}
+		else
+		{
+			Operation.OnLoaded.ExecuteIfBound(bLoaded);
+		}
+	}
+
+	ProcessSaveQueue();
+}
+
 void UVisualUBlueprintStatics::SerializeVisualU(FArchive& Ar, UVisualVersioningSubsystem* VersioningSubsystem, UVisualController* VisualController)
 {
 	check(VersioningSubsystem);
 	check(VisualController);
 
-	FObjectAndNameAsStringProxyArchive ProxyAr(Ar, /*bInLoadIfFindFails=*/false);
-	VersioningSubsystem->SerializeSubsystem(ProxyAr);
-	VisualController->SerializeController(ProxyAr);
+	uint32 Magic = UE::VisualU::Private::SaveMagic;
+	if (Ar.IsSaving())
+	{
+		/*Body is written first, so that the string table is complete*/
+		TArray<uint8> Body;
+		TArray<FString> Strings;
+		FMemoryWriter BodyWriter(Body);
+		BodyWriter.UsingCustomVersion(FVisualUCustomVersion::GUID);
+		FVisualUSaveArchive SaveAr(BodyWriter, Strings);
+		VersioningSubsystem->SerializeSubsystem(SaveAr);
+		VisualController->SerializeController(SaveAr);
+
+		FCustomVersionContainer CustomVersions = BodyWriter.GetCustomVersions();
+		Ar << Magic;
+		CustomVersions.Serialize(Ar);
+		Ar << Strings;
+		Ar << Body;
+
+		return;
+	}
+
+	const int64 SaveStart = Ar.Tell();
+	Ar << Magic;
+	if (Magic != UE::VisualU::Private::SaveMagic)
+	{
+		/*Migration from saves made before FVisualUCustomVersion::CompactSaveFormat*/
+		Ar.Seek(SaveStart);
+		Ar.SetCustomVersion(FVisualUCustomVersion::GUID, FVisualUCustomVersion::BeforeCustomVersionWasAdded, TEXT("VisualUVersion"));
+
+		FObjectAndNameAsStringProxyArchive ProxyAr(Ar, /*bInLoadIfFindFails=*/false);
+		VersioningSubsystem->SerializeSubsystem(ProxyAr);
+		VisualController->SerializeController(ProxyAr);
+
+		return;
+	}
+
+	FCustomVersionContainer CustomVersions;
+	CustomVersions.Serialize(Ar);
+	TArray<FString> Strings;
+	Ar << Strings;
+	TArray<uint8> Body;
+	Ar << Body;
+
+	FMemoryReader BodyReader(Body);
+	BodyReader.SetCustomVersions(CustomVersions);
+	FVisualUSaveArchive LoadAr(BodyReader, Strings);
+	VersioningSubsystem->SerializeSubsystem(LoadAr);
+	VisualController->SerializeController(LoadAr);
 }
@@ -0,0 +1,162 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+
+#include "VisualUSaveArchive.h"
+#include "UObject/ObjectPtr.h"
+#include "UObject/SoftObjectPtr.h"
+#include "UObject/WeakObjectPtr.h"
+#include "VisualU.h"
+
+FVisualUSaveArchive::FVisualUSaveArchive(FArchive& InInnerArchive, TArray<FString>& InStrings)
+	: FArchiveProxy(InInnerArchive),
+	Strings(InStrings),
+	StringIndices()
+{
+	if (IsSaving())
+	{
+		StringIndices.Reserve(Strings.Num());
+		for (int32 i = 0; i < Strings.Num(); i++)
+		{
+			StringIndices.Add(Strings[i], i + 1);
+		}
+	}
+}
+
+FArchive& FVisualUSaveArchive::operator<<(FName& Value)
+{
+	FString Name;
+	if (IsSaving() && !Value.IsNone())
+	{
+		Name = Value.ToString();
+	}
+
+	SerializeInterned(Name);
+
+	if (IsLoading())
+	{
+		Value = Name.IsEmpty() ? NAME_None : FName(*Name);
+	}
+
+	return *this;
+}
+
+FArchive& FVisualUSaveArchive::operator<<(UObject*& Value)
+{
+	FString Path;
+	if (IsSaving() && Value)
+	{
+		Path = Value->GetPathName();
+	}
+
+	SerializeInterned(Path);
+
+	if (IsLoading())
+	{
+		Value = Path.IsEmpty() ? nullptr : FindObject<UObject>(nullptr, *Path);
+	}
+
+	return *this;
+}
+
+FArchive& FVisualUSaveArchive::operator<<(FObjectPtr& Value)
+{
+	UObject* Object = Value.Get();
+	*this << Object;
+
+	if (IsLoading())
+	{
+		Value = Object;
+	}
+
+	return *this;
+}
+
+FArchive& FVisualUSaveArchive::operator<<(FWeakObjectPtr& Value)
+{
+	UObject* Object = Value.Get();
+	*this << Object;
+
+	if (IsLoading())
+	{
+		Value = Object;
+	}
+
+	return *this;
+}
+
+FArchive& FVisualUSaveArchive::operator<<(FSoftObjectPtr& Value)
+{
+	FSoftObjectPath Path = Value.ToSoftObjectPath();
+	*this << Path;
+
+	if (IsLoading())
+	{
+		Value = Path;
+	}
+
+	return *this;
+}
+
+FArchive& FVisualUSaveArchive::operator<<(FSoftObjectPath& Value)
+{
+	FString Path;
+	if (IsSaving() && !Value.IsNull())
+	{
+		Path = Value.ToString();
+	}
+
+	SerializeInterned(Path);
+
+	if (IsLoading())
+	{
+		Value = Path.IsEmpty() ? FSoftObjectPath() : FSoftObjectPath(Path);
+	}
+
+	return *this;
+}
+
+FString FVisualUSaveArchive::GetArchiveName() const
+{
+	return TEXT("FVisualUSaveArchive");
+}
+
+void FVisualUSaveArchive::SerializeInterned(FString& Value)
+{
+	uint32 Index = 0;
+	if (IsSaving())
+	{
+		if (!Value.IsEmpty())
+		{
+			if (const uint32* StringIndex = StringIndices.Find(Value))
+			{
+				Index = *StringIndex;
+			}
+			else
+			{
+				Index = Strings.Add(Value) + 1;
+				StringIndices.Add(Value, Index);
+			}
+		}
+
+		SerializeIntPacked(Index);
+	}
+	else
+	{
+		SerializeIntPacked(Index);
+
+		if (Index == 0)
+		{
+			Value.Reset();
+		}
+		else if (Strings.IsValidIndex(Index - 1))
+		{
+			Value = Strings[Index - 1];
+		}
+		else
+		{
+			UE_LOG(LogVisualU, Warning, TEXT("Corrupted save: string index %u is out of range."), Index);
+			SetError();
+			Value.Reset();
+		}
+	}
+}
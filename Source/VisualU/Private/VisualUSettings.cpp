@@ -3,6 +3,7 @@
 
 #include "VisualUSettings.h"
 #include "Scenario.h"
+#include "VisualSprite.h"
 
 // None, Character, Choice
 constexpr int32 CustomEnumOffset = 3;		
@@ -10,6 +11,13 @@ constexpr int32 CustomEnumOffset = 3;
 UVisualUSettings::UVisualUSettings(const FObjectInitializer& ObjectInitializer) 
 	: Super(ObjectInitializer),
 	FirstDataTable(),
+	bUseStoryPack(false),
+	StoryPackPath(TEXT("VisualU/Story.vspack")),
+	bLazyVersionRestore(false),
+	SpritePoolSize(4),
+	SpritePoolSizeOverrides(),
+	bDoubleBufferedRenderer(false),
+	SpriteConstructionBudget(0.f),
 	TransitionMPC(),
 	TransitionDuration(0.f),
 	AParameterName(TEXT("Transition 1")),
@@ -3,40 +3,78 @@
 
 #include "VisualVersioningSubsystem.h"
 #include "VisualUCustomVersion.h"
+#include "ScenarioNodeCache.h"
+#include "VisualUSettings.h"
+#include "VisualU.h"
+#include "VisualUSaveArchive.h"
+#include "Serialization/MemoryReader.h"
+
+DECLARE_MEMORY_STAT(TEXT("Scene Versions"), STAT_SceneVersionsMemory, STATGROUP_VisualU);
+DECLARE_CYCLE_STAT(TEXT("Restore Versions"), STAT_RestoreVersions, STATGROUP_VisualU);
 
 UVisualVersioningSubsystem::UVisualVersioningSubsystem()
 	: Super(),
-	Versions()
+	Versions(),
+	VersionedScenes(),
+	PendingScenes()
 {
 }
 
 void UVisualVersioningSubsystem::AlterDataTable(const UDataTable* DataTable, const FName& SceneName, const FVisualScenarioInfo& Version)
 {
+	RestoreVersions(DataTable);
 	FScenario* Scene = GetSceneChecked(DataTable, SceneName);
-	FScenarioId Id{Scene->GetOwner(), Scene->GetIndex()};
-	Versions.Add(MoveTemp(Id), Scene->Info);
+	FScenarioInfoPatch PreviousVersion = FScenarioInfoPatch::Diff(Scene->Info, Version);
+	AddVersion(FScenarioId{ Scene->GetOwner(), Scene->GetIndex() }, MoveTemp(PreviousVersion));
 	Scene->Info = Version;
 }
 
 void UVisualVersioningSubsystem::Checkout(FScenario* Scene) const
 {
 	check(Scene);
-	FScenarioId Id{ Scene->GetOwner(), Scene->GetIndex() };
-	if (const FVisualScenarioInfo* Version = Versions.Find(Id))
+	ApplyCheckout(FScenarioId{ Scene->GetOwner(), Scene->GetIndex() }, *Scene);
+}
+
+bool UVisualVersioningSubsystem::ApplyCheckout(const FScenarioId& Id, FScenario& Scene) const
+{
+	if (const FScenarioInfoPatch* Version = Versions.Find(Id))
 	{
-		Scene->Info = *Version;
+		Version->Apply(Scene.Info);
+		return true;
 	}
+
+	return false;
 }
 
 void UVisualVersioningSubsystem::CheckoutAll(const UDataTable* DataTable) const
 {
 	check(DataTable);
-	TArray<FScenario*> Rows;
-	DataTable->GetAllRows(UE_SOURCE_LOCATION, Rows);
+	const TSet<int32>* Indices = VersionedScenes.Find(TSoftObjectPtr<const UDataTable>(DataTable));
+	if (!Indices)
+	{
+		return;
+	}
+
+	FScenarioNodeCache& NodeCache = FScenarioNodeCache::Get();
+	for (const int32 Index : *Indices)
+	{
+		if (FScenario* Scene = NodeCache.GetSceneAt(DataTable, Index))
+		{
+			Checkout(Scene);
+		}
+	}
+}
+
+void UVisualVersioningSubsystem::CheckoutAll(TConstArrayView<const UDataTable*> DataTables) const
+{
+	if (VersionedScenes.IsEmpty())
+	{
+		return;
+	}
 
-	for (FScenario*& Row : Rows)
+	for (const UDataTable* DataTable : DataTables)
 	{
-		Checkout(Row);
+		CheckoutAll(DataTable);
 	}
 }
 
@@ -47,41 +85,36 @@ void UVisualVersioningSubsystem::SerializeSubsystem(FArchive& Ar)
 
 	Super::Serialize(Ar);
 
-	if (Ar.IsSaving())
+	/*Whole save is rewritten by the platform, so versions are always saved in full*/
+	bool bIsJournal = false;
+	if (Ar.CustomVer(FVisualUCustomVersion::GUID) >= FVisualUCustomVersion::VersioningJournal)
 	{
-		TSet<FScenarioId> SceneIDs;
-		Versions.GetKeys(SceneIDs);
-		int32 NumScenes = SceneIDs.Num();
-		Ar << NumScenes;
-		for (FScenarioId& SceneId : SceneIDs)
-		{
-			FScenario* Scene = GetSceneChecked(SceneId);
-			Ar << *Scene;
-			TArray<FVisualScenarioInfo> Infos;
-			Versions.MultiFind(SceneId, Infos, /*bMaintainOrder=*/true);
-			Infos.Add(Scene->Info);
-			Ar << Infos;
-		}
+		Ar << bIsJournal;
 	}
-	else
+
+	if (!bIsJournal || Ar.IsSaving())
 	{
-		int32 NumScenes = 0;
-		Ar << NumScenes;
-		Versions.Reserve(NumScenes);
-		for (int32 i = 0; i < NumScenes; i++)
-		{
-			FScenario Scene;
-			Ar << Scene;
-			TArray<FVisualScenarioInfo> Infos;
-			Ar << Infos;
-			FScenario* ResolvedScene = FScenario::ResolveScene(Scene);
-			ResolvedScene->Info = Infos.Pop();
-			for (FVisualScenarioInfo& Info : Infos)
-			{
-				FScenarioId Id {Scene.GetOwner(), Scene.GetIndex()};
-				Versions.Add(Id, Info);
-			}
-		}
+		SerializeVersions(Ar);
+		return;
+	}
+
+	/*Older saves might store versions as a snapshot followed by the journal of changes*/
+	TArray<FString> JournalStrings;
+	int32 NumJournalRecords = 0;
+	TArray<uint8> Journal;
+	Ar << JournalStrings;
+	Ar << NumJournalRecords;
+	Ar << Journal;
+
+	FMemoryReader JournalReader(Journal);
+	JournalReader.SetCustomVersions(Ar.GetCustomVersions());
+	FVisualUSaveArchive JournalAr(JournalReader, JournalStrings);
+	SerializeVersions(JournalAr);
+
+	FJournalRecord Record;
+	for (int32 i = 0; i < NumJournalRecords && !JournalAr.IsError(); i++)
+	{
+		LoadRecord(JournalAr, Record);
 	}
 }
 
@@ -100,14 +133,20 @@ void UVisualVersioningSubsystem::Deinitialize()
 	for (FScenarioId& SceneId : SceneIDs)
 	{
 		FScenario* Scene = GetSceneChecked(SceneId);
-		TArray<FVisualScenarioInfo> Infos;
-		Versions.MultiFind(SceneId, Infos, /*bMaintainOrder=*/true);
-		if (!Infos.IsEmpty())
+		TArray<FScenarioInfoPatch> Patches;
+		Versions.MultiFind(SceneId, Patches, /*bMaintainOrder=*/true);
+
+		//Reset scene to initial, asset state
+		for (int32 i = Patches.Num() - 1; i >= 0; i--)
 		{
-			//Reset scene to initial, asset state
-			Scene->Info = Infos[0];
+			Patches[i].Apply(Scene->Info);
 		}
 	}
+
+	Versions.Empty();
+	SET_MEMORY_STAT(STAT_SceneVersionsMemory, 0);
+	PendingScenes.Empty();
+	VersionedScenes.Empty();
 }
 
 FScenario* UVisualVersioningSubsystem::GetSceneChecked(const UDataTable* DataTable, const FName& SceneName) const
@@ -124,13 +163,244 @@ FScenario* UVisualVersioningSubsystem::GetSceneChecked(const FScenarioId& Id) co
 {
 	checkf(!Id.SoftOwner.IsNull(), TEXT("Can't identify a scene with invalid owner."));
 
-	const UDataTable* Owner = Id.SoftOwner.LoadSynchronous();
+	const UDataTable* Owner = FVisualStoryPack::LoadNode(Id.SoftOwner.ToSoftObjectPath());
 	check(Owner);
 
-	TArray<FScenario*> Rows;
-	Owner->GetAllRows(UE_SOURCE_LOCATION, Rows);
+	FScenario* Scene = FScenarioNodeCache::Get().GetSceneAt(Owner, Id.Index);
+	check(Scene);
+
+	return Scene;
+}
+
+void UVisualVersioningSubsystem::AddVersion(const FScenarioId& Id, FScenarioInfoPatch&& Version)
+{
+	INC_MEMORY_STAT_BY(STAT_SceneVersionsMemory, Version.GetAllocatedSize());
+	Versions.Add(Id, MoveTemp(Version));
+	VersionedScenes.FindOrAdd(Id.SoftOwner).Add(Id.Index);
+}
+
+void UVisualVersioningSubsystem::SerializeVersions(FArchive& Ar)
+{
+	if (Ar.IsSaving())
+	{
+		/*Loaded journal records are not saved, so such nodes are restored before saving*/
+		TArray<TSoftObjectPtr<const UDataTable>, TInlineAllocator<4>> NodesToRestore;
+		for (const TPair<TSoftObjectPtr<const UDataTable>, TMap<int32, FPendingScene>>& PendingNode : PendingScenes)
+		{
+			for (const TPair<int32, FPendingScene>& PendingScene : PendingNode.Value)
+			{
+				if (!PendingScene.Value.Records.IsEmpty())
+				{
+					NodesToRestore.Add(PendingNode.Key);
+					break;
+				}
+			}
+		}
+
+		for (const TSoftObjectPtr<const UDataTable>& NodeToRestore : NodesToRestore)
+		{
+			RestoreVersions(FVisualStoryPack::LoadNode(NodeToRestore.ToSoftObjectPath()));
+		}
+
+		TSet<FScenarioId> SceneIDs;
+		Versions.GetKeys(SceneIDs);
+		int32 NumScenes = SceneIDs.Num();
+		for (const TPair<TSoftObjectPtr<const UDataTable>, TMap<int32, FPendingScene>>& PendingNode : PendingScenes)
+		{
+			NumScenes += PendingNode.Value.Num();
+		}
+
+		Ar << NumScenes;
+		for (FScenarioId& SceneId : SceneIDs)
+		{
+			FScenario* Scene = GetSceneChecked(SceneId);
+			SerializeSceneId(Ar, SceneId);
+			TArray<FScenarioInfoPatch> Patches;
+			Versions.MultiFind(SceneId, Patches, /*bMaintainOrder=*/true);
+			Ar << Patches;
+			Ar << Scene->Info;
+		}
+
+		/*Scenes that were not restored are saved as they were loaded*/
+		for (TPair<TSoftObjectPtr<const UDataTable>, TMap<int32, FPendingScene>>& PendingNode : PendingScenes)
+		{
+			for (TPair<int32, FPendingScene>& PendingScene : PendingNode.Value)
+			{
+				FScenarioId SceneId{ PendingNode.Key, PendingScene.Key };
+				SerializeSceneId(Ar, SceneId);
+				Ar << PendingScene.Value.Patches;
+				Ar << PendingScene.Value.Info;
+			}
+		}
+	}
+	else
+	{
+		/*Versions that were not restored belong to the previous load*/
+		PendingScenes.Empty();
+
+		const bool bRestoreLazily = CanRestoreLazily(Ar);
+		int32 NumScenes = 0;
+		Ar << NumScenes;
+		Versions.Reserve(NumScenes);
+		for (int32 i = 0; i < NumScenes; i++)
+		{
+			FScenarioId Id;
+			SerializeSceneId(Ar, Id);
+
+			if (Ar.CustomVer(FVisualUCustomVersion::GUID) < FVisualUCustomVersion::ScenarioInfoPatches)
+			{
+				/*Full copies of the versions followed by the current information*/
+				FScenario* ResolvedScene = GetSceneChecked(Id);
+				TArray<FVisualScenarioInfo> Infos;
+				Ar << Infos;
+				ResolvedScene->Info = Infos.Pop();
+				for (int32 j = 0; j < Infos.Num(); j++)
+				{
+					const FVisualScenarioInfo& NextInfo = Infos.IsValidIndex(j + 1) ? Infos[j + 1] : ResolvedScene->Info;
+					AddVersion(Id, FScenarioInfoPatch::Diff(Infos[j], NextInfo));
+				}
+
+				continue;
+			}
+
+			TArray<FScenarioInfoPatch> Patches;
+			FVisualScenarioInfo Info;
+			Ar << Patches;
+			Ar << Info;
+
+			if (FPendingScene* PendingScene = FindPendingScene(Id, bRestoreLazily))
+			{
+				PendingScene->Patches = MoveTemp(Patches);
+				PendingScene->Info = MoveTemp(Info);
+				PendingScene->bHasSnapshot = true;
+
+				continue;
+			}
+
+			FScenario* ResolvedScene = GetSceneChecked(Id);
+			ResolvedScene->Info = MoveTemp(Info);
+			for (FScenarioInfoPatch& Patch : Patches)
+			{
+				AddVersion(Id, MoveTemp(Patch));
+			}
+		}
+	}
+}
+
+void UVisualVersioningSubsystem::LoadRecord(FArchive& Ar, FJournalRecord& Record)
+{
+	check(Ar.IsLoading());
+	uint8 Op = 0;
+	Ar << Op;
+	Record.Op = StaticCast<EJournalOp>(Op);
+
+	SerializeSceneId(Ar, Record.Id);
+
+	if (Record.Op == EJournalOp::Alter)
+	{
+		if (Ar.CustomVer(FVisualUCustomVersion::GUID) < FVisualUCustomVersion::ScenarioInfoPatches)
+		{
+			FVisualScenarioInfo Info;
+			Ar << Info;
+			Record.Patch = FScenarioInfoPatch(Info, FScenarioInfoPatch::Diff(GetSceneChecked(Record.Id)->Info, Info).GetStoredMembers());
+		}
+		else
+		{
+			Ar << Record.Patch;
+		}
+	}
+
+	if (FPendingScene* PendingScene = FindPendingScene(Record.Id, CanRestoreLazily(Ar)))
+	{
+		PendingScene->Records.Add(Record);
+		return;
+	}
 
-	check(Rows.IsValidIndex(Id.Index));
+	ApplyRecord(*GetSceneChecked(Record.Id), Record);
+}
 
-	return Rows[Id.Index];
+void UVisualVersioningSubsystem::ApplyRecord(FScenario& Scene, const FJournalRecord& Record)
+{
+	if (Record.Op == EJournalOp::Alter)
+	{
+		AddVersion(Record.Id, FScenarioInfoPatch(Scene.Info, Record.Patch.GetStoredMembers()));
+		Record.Patch.Apply(Scene.Info);
+	}
+	else
+	{
+		ApplyCheckout(Record.Id, Scene);
+	}
+}
+
+void UVisualVersioningSubsystem::SerializeSceneId(FArchive& Ar, FScenarioId& Id)
+{
+	/*Same layout as FScenario, but the owner is not loaded*/
+	TSoftObjectPtr<UDataTable> SoftOwner(Id.SoftOwner.ToSoftObjectPath());
+	Ar << SoftOwner;
+	Ar << Id.Index;
+
+	if (Ar.IsLoading())
+	{
+		Id.SoftOwner = TSoftObjectPtr<const UDataTable>(SoftOwner.ToSoftObjectPath());
+	}
+}
+
+bool UVisualVersioningSubsystem::CanRestoreLazily(const FArchive& Ar)
+{
+	return Ar.IsLoading()
+		&& GetDefault<UVisualUSettings>()->bLazyVersionRestore
+		&& Ar.CustomVer(FVisualUCustomVersion::GUID) >= FVisualUCustomVersion::ScenarioInfoPatches;
+}
+
+UVisualVersioningSubsystem::FPendingScene* UVisualVersioningSubsystem::FindPendingScene(const FScenarioId& Id, bool bRestoreLazily)
+{
+	if (TMap<int32, FPendingScene>* PendingNode = PendingScenes.Find(Id.SoftOwner))
+	{
+		return &PendingNode->FindOrAdd(Id.Index);
+	}
+
+	/*Nodes in memory are restored right away*/
+	if (bRestoreLazily && !Id.SoftOwner.Get())
+	{
+		return &PendingScenes.Add(Id.SoftOwner).Add(Id.Index);
+	}
+
+	return nullptr;
+}
+
+void UVisualVersioningSubsystem::RestoreVersions(const UDataTable* DataTable)
+{
+	TMap<int32, FPendingScene> PendingNode;
+	if (!DataTable || PendingScenes.IsEmpty() || !PendingScenes.RemoveAndCopyValue(TSoftObjectPtr<const UDataTable>(DataTable), PendingNode))
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_RestoreVersions);
+	FScenarioNodeCache& NodeCache = FScenarioNodeCache::Get();
+	for (TPair<int32, FPendingScene>& Pending : PendingNode)
+	{
+		FScenario* Scene = NodeCache.GetSceneAt(DataTable, Pending.Key);
+		if (!Scene)
+		{
+			UE_LOG(LogVisualU, Warning, TEXT("Can't restore versions of scene %i in Data Table: %s"), Pending.Key, *DataTable->GetFName().ToString());
+			continue;
+		}
+
+		const FScenarioId Id{ DataTable, Pending.Key };
+		FPendingScene& PendingScene = Pending.Value;
+		if (PendingScene.bHasSnapshot)
+		{
+			Scene->Info = MoveTemp(PendingScene.Info);
+			for (FScenarioInfoPatch& Patch : PendingScene.Patches)
+			{
+				AddVersion(Id, MoveTemp(Patch));
+			}
+		}
+
+		for (const FJournalRecord& Record : PendingScene.Records)
+		{
+			ApplyRecord(*Scene, Record);
+		}
+	}
 }
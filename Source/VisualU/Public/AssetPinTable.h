@@ -0,0 +1,95 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+
+struct FStreamableHandle;
+
+/**
+* Reference counted table of assets kept in memory.
+* Every unique asset is requested once, no matter how many
+* scenes refer to it, and released when the last of them is unpinned.
+*
+* @see FSceneResidencyCache
+*/
+class VISUALU_API FAssetPinTable
+{
+public:
+	FAssetPinTable();
+
+	/**
+	* Pins provided assets. Only assets that are not pinned yet are requested.
+	*
+	* @note every pin must be matched by Unpin with the same assets
+	*
+	* @param Paths unique assets to pin
+	* @param DebugName name for the handle in debug tools
+	* @return handle owned by the caller that completes when all provided assets are loaded,
+	*		  nullptr when there is nothing to load
+	*/
+	TSharedPtr<FStreamableHandle> Pin(TConstArrayView<FSoftObjectPath> Paths, const FString& DebugName);
+
+	/**
+	* Unpins provided assets. Assets that are no longer pinned are released.
+	*
+	* @param Paths unique assets to unpin
+	*/
+	void Unpin(TConstArrayView<FSoftObjectPath> Paths);
+
+	/**
+	* Releases all assets.
+	*/
+	void Empty();
+
+	/**
+	* Estimates size of the pinned assets that finished loading since the last call.
+	* Size of the asset is released when it is no longer pinned.
+	*
+	* @return estimated size, in bytes, of the loaded pinned assets
+	*/
+	int64 Measure();
+
+	/**
+	* @return estimated size, in bytes, of the measured pinned assets
+	*
+	* @see FAssetPinTable::Measure()
+	*/
+	FORCEINLINE int64 GetPinnedBytes() const { return PinnedBytes; }
+
+	/**
+	* @return number of unique pinned assets
+	*/
+	FORCEINLINE int32 Num() const { return Pins.Num(); }
+
+	/**
+	* @param Path asset to look for
+	* @return number of pins of the asset
+	*/
+	int32 GetPinCount(const FSoftObjectPath& Path) const;
+
+private:
+	/**
+	* Asset kept in memory.
+	*/
+	struct FPinnedAsset
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+
+		int32 PinCount = 0;
+
+		/**
+		* Estimated size of the loaded asset, INDEX_NONE until it is loaded.
+		*/
+		int64 SizeBytes = INDEX_NONE;
+	};
+
+	TMap<FSoftObjectPath, FPinnedAsset> Pins;
+
+	/**
+	* Every unique asset is accounted once.
+	*/
+	int64 PinnedBytes;
+
+};
@@ -75,10 +75,24 @@ protected:
 
 private:
 	/**
+	* Textures of the transition material are only set when they differ from the bound ones.
+	* 
 	* @see SVisualImageBase::GetFinalResource()
 	*/
 	virtual UObject* GetFinalResource() const override;
 
+	/**
+	* Transition brush is outdated when sprite of the animated flipbook changes.
+	* 
+	* @see SVisualImageBase::IsBrushOutdated()
+	*/
+	virtual bool IsBrushOutdated(const FSlateBrush& Brush) const override;
+
+	/**
+	* Forgets sprites and textures bound to the transition material.
+	*/
+	void ResetTransitionBindings();
+
 	/**
 	* Retrieves sprite from SBackgroundVisualImage::Target.
 	*/
@@ -109,4 +123,16 @@ private:
 	* @see UBackgroundVisualImage::StartTransition(UPaperFlipbook*, UMaterialInstanceDynamic*, int32)
 	*/
 	int32 TargetFrameIndex;
+
+	/**
+	* Sprites the transition brush was made from, only used for comparison.
+	*/
+	mutable const UPaperSprite* TransitionSprite;
+	mutable const UPaperSprite* TransitionTargetSprite;
+
+	/**
+	* Textures set to the transition material, only used for comparison.
+	*/
+	mutable const UTexture* BoundATexture;
+	mutable const UTexture* BoundBTexture;
 };
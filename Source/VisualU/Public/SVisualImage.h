@@ -254,6 +254,14 @@ public:
 	*/
 	virtual const FVector2D GetImageSize() const;
 
+	/**
+	* @see SVisualImageBase::IsBrushOutdated()
+	* 
+	* @param Brush cached brush
+	* @return {@code true} when the brush doesn't display the current sprite
+	*/
+	virtual bool IsBrushOutdated(const FSlateBrush& Brush) const;
+
 	/**
 	* Applies SVisualImage::ColorAndOpacity to the final color of the flipbook.
 	* 
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Animation/CurveSequence.h"
 #include "Widgets/SLeafWidget.h"
+#include "VisualU.h"
 
 class UPaperFlipbook;
 class UPaperSprite;
@@ -14,6 +15,7 @@ class SVisualImage;
 * Base slate class for widgets that can display some render resource.
 * Utilizes CRTP with double dispatch for derived classes,
 * template function is SVisualImageBase::ConvertToBrush.
+* Converted brush is cached until it is invalidated or outdated.
 * 
 * @param DerivedT derived class of SVisualImageBase
 * 
@@ -33,6 +35,21 @@ protected:
 	*/
 	virtual FSlateBrush ConvertToBrush() const final;
 
+	/**
+	* Converts render resource to the brush only when cached brush
+	* is invalidated or outdated, since conversion resolves the resource and its size.
+	* 
+	* @return brush made from SVisualImageBase::GetFinalResource()
+	* 
+	* @see SVisualImageBase::IsBrushOutdated()
+	*/
+	const FSlateBrush& GetBrush() const;
+
+	/**
+	* Forces the brush to be converted on the next use.
+	*/
+	FORCEINLINE void InvalidateBrush() { bIsBrushValid = false; }
+
 	/**
 	* Paints render resource as a brush after applying all modifiers.
 	* 
@@ -66,6 +83,12 @@ protected:
 	*/
 	const FVector2D GetImageSize() const;
 
+	/**
+	* @param Brush cached brush
+	* @return {@code true} when render resource no longer matches the cached brush
+	*/
+	bool IsBrushOutdated(const FSlateBrush& Brush) const;
+
 	/**
 	* @param InWidgetStyle base widget style
 	* @return color and opacity to be applied to the resource
@@ -100,6 +123,17 @@ private:
 	~SVisualImageBase() = default;
 
 	friend DerivedT;
+
+private:
+	/**
+	* Brush converted from the render resource.
+	*/
+	mutable FSlateBrush CachedBrush = FSlateBrush();
+
+	/**
+	* Whether SVisualImageBase::CachedBrush can be used.
+	*/
+	mutable bool bIsBrushValid = false;
 };
 
 template<class DerivedT>
@@ -126,10 +160,24 @@ inline FSlateBrush SVisualImageBase<DerivedT>::ConvertToBrush() const
 	return Brush;
 }
 
+template<class DerivedT>
+inline const FSlateBrush& SVisualImageBase<DerivedT>::GetBrush() const
+{
+	if (!bIsBrushValid || IsBrushOutdated(CachedBrush))
+	{
+		INC_DWORD_STAT(STAT_VisualImageBrushBuilds);
+		CachedBrush = ConvertToBrush();
+		bIsBrushValid = true;
+	}
+
+	return CachedBrush;
+}
+
 template<class DerivedT>
 inline int32 SVisualImageBase<DerivedT>::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
 {
-	const FSlateBrush Brush = ConvertToBrush();
+	SCOPE_CYCLE_COUNTER(STAT_PaintVisualImages);
+	const FSlateBrush& Brush = GetBrush();
 
 	const FLinearColor FinalColorAndOpacity = GetFinalColorAndOpacity(InWidgetStyle);
 
@@ -166,6 +214,12 @@ inline const FVector2D SVisualImageBase<DerivedT>::GetImageSize() const
 	return static_cast<const DerivedT*>(this)->GetImageSize();
 }
 
+template<class DerivedT>
+inline bool SVisualImageBase<DerivedT>::IsBrushOutdated(const FSlateBrush& Brush) const
+{
+	return static_cast<const DerivedT*>(this)->IsBrushOutdated(Brush);
+}
+
 template<class DerivedT>
 inline const FLinearColor SVisualImageBase<DerivedT>::GetFinalColorAndOpacity(const FWidgetStyle& InWidgetStyle) const
 {
@@ -8,6 +8,8 @@
 #include "VisualDefaults.h"
 #include "VisualImage.h"
 #include "InfoAssignable.h"
+#include "ScenarioNodeCache.h"
+#include "VisualStoryPack.h"
 #include "Scenario.generated.h"
 
 class UPaperFlipbook;
@@ -333,6 +335,15 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scenario")
 	FVisualScenarioInfo Info;
 
+	/**
+	* Nodes that might be requested when this scenario has EScenarioMetaFlags::Choice.
+	* Used as a hint for UVisualController to prepare choice options in advance.
+	* 
+	* @see UVisualController::RequestNode()
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scenario", meta = (ToolTip = "Nodes that might be requested when this scenario has a choice. Their first scenarios are loaded in advance."))
+	TArray<TSoftObjectPtr<UDataTable>> ChoiceTargets;
+
 protected:
 	/**
 	* Node that owns this scenario. Can be null.
@@ -357,14 +368,10 @@ public:
 	{
 		if (ensure(Scene.GetOwner()))
 		{
-			TArray<FScenario*> Scenes;
-			Scene.GetOwner()->GetAllRows(UE_SOURCE_LOCATION, Scenes);
-			const int32 Idx = Scene.GetIndex();
+			FScenario* ResolvedScene = FScenarioNodeCache::Get().GetSceneAt(Scene.GetOwner(), Scene.GetIndex());
+			ensure(ResolvedScene);
 
-			if (ensure(Scenes.IsValidIndex(Idx)))
-			{
-				return Scenes[Idx];
-			}
+			return ResolvedScene;
 		}
 
 		return nullptr;
@@ -513,7 +520,7 @@ public:
 
 		if (Ar.IsLoading() && !SoftOwner.IsNull())
 		{
-			Scenario.Owner = SoftOwner.LoadSynchronous();
+			Scenario.Owner = FVisualStoryPack::LoadNode(SoftOwner.ToSoftObjectPath());
 		}
 
 		return Ar << Scenario.Index;
@@ -532,14 +539,18 @@ public:
 private:
 	/**
 	* Makes this scenario aware of its owner and its position.
+	* The first row of the data table assigns owner and index
+	* to every row at once, other rows are only resolved if
+	* they were not part of that pass.
 	* 
 	* @param InDataTable the owner of this scenario
 	*/
-	inline void Intrude(const UDataTable* InDataTable)
-	{
-		Owner = InDataTable;
-		TArray<FScenario*> Rows;
-		InDataTable->GetAllRows(UE_SOURCE_LOCATION, Rows);
-		Rows.Find(this, Index);
-	}
+	void Intrude(const UDataTable* InDataTable);
+
+	/**
+	* Assigns owner and position to all rows of the data table in a single pass.
+	* 
+	* @param InDataTable data table based on FScenario
+	*/
+	static void IntrudeAll(const UDataTable* InDataTable);
 };
@@ -0,0 +1,117 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Scenario.h"
+
+/**
+* Members of FVisualScenarioInfo stored by FScenarioInfoPatch.
+*/
+enum class EScenarioInfoMembers : uint8
+{
+	None = 0,
+	Author = 1 << 0,
+	Line = 1 << 1,
+	Sound = 1 << 2,
+	Background = 1 << 3,
+	SpritesParams = 1 << 4,
+	Flags = 1 << 5,
+	All = Author | Line | Sound | Background | SpritesParams | Flags
+};
+
+ENUM_CLASS_FLAGS(EScenarioInfoMembers);
+
+/**
+* Values of some members of FVisualScenarioInfo.
+* Members that are not stored stay default constructed,
+* so unchanged sprites and texts are not copied.
+*
+* @see UVisualVersioningSubsystem
+*/
+struct VISUALU_API FScenarioInfoPatch
+{
+public:
+	FScenarioInfoPatch();
+
+	/**
+	* Copies provided members of the info.
+	*
+	* @param Info information to copy members from
+	* @param InMembers members to copy
+	*/
+	FScenarioInfoPatch(const FVisualScenarioInfo& Info, EScenarioInfoMembers InMembers);
+
+	/**
+	* @param From information to copy members from
+	* @param To information to compare with
+	* @return patch with members of From that are different in To
+	*/
+	static FScenarioInfoPatch Diff(const FVisualScenarioInfo& From, const FVisualScenarioInfo& To);
+
+	/**
+	* @param Pointers pointers to members of FVisualScenarioInfo
+	* @return members that are referred to by pointers
+	*
+	* @see UpdateMembers
+	*/
+	template<typename... V>
+	static EScenarioInfoMembers GetMembers(V FVisualScenarioInfo::*... Pointers)
+	{
+		return (EScenarioInfoMembers::None | ... | GetMember(Pointers));
+	}
+
+	/**
+	* Assigns stored members to the info.
+	*
+	* @param Info information to patch
+	*/
+	void Apply(FVisualScenarioInfo& Info) const;
+
+	/**
+	* @return memory allocated by this patch, including its size
+	*/
+	SIZE_T GetAllocatedSize() const;
+
+	/**
+	* @return stored members
+	*/
+	FORCEINLINE EScenarioInfoMembers GetStoredMembers() const { return Members; }
+
+	friend VISUALU_API FArchive& operator<<(FArchive& Ar, FScenarioInfoPatch& Patch);
+
+private:
+	static EScenarioInfoMembers GetMember(FText FVisualScenarioInfo::* Pointer)
+	{
+		return Pointer == &FVisualScenarioInfo::Author ? EScenarioInfoMembers::Author : EScenarioInfoMembers::Line;
+	}
+
+	static EScenarioInfoMembers GetMember(TSoftObjectPtr<USoundBase> FVisualScenarioInfo::*)
+	{
+		return EScenarioInfoMembers::Sound;
+	}
+
+	static EScenarioInfoMembers GetMember(FBackground FVisualScenarioInfo::*)
+	{
+		return EScenarioInfoMembers::Background;
+	}
+
+	static EScenarioInfoMembers GetMember(TArray<FSprite> FVisualScenarioInfo::*)
+	{
+		return EScenarioInfoMembers::SpritesParams;
+	}
+
+	static EScenarioInfoMembers GetMember(uint8 FVisualScenarioInfo::*)
+	{
+		return EScenarioInfoMembers::Flags;
+	}
+
+private:
+	EScenarioInfoMembers Members;
+
+	/**
+	* Only stored members are assigned.
+	*/
+	FVisualScenarioInfo Values;
+
+};
@@ -0,0 +1,117 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class UDataTable;
+struct FScenario;
+
+/**
+* Shared positional index of scenes in nodes.
+* Each node (data table based on FScenario) is indexed once and
+* kept until the data table is changed, reimported or destroyed,
+* so that index-to-scene and scene-to-index lookups are O(1)
+* and do not allocate.
+*
+* @note game thread only
+*
+* @see FScenario
+*	   UVisualController
+*/
+class VISUALU_API FScenarioNodeCache
+{
+public:
+	/**
+	* @return cache shared by all VisualU objects
+	*/
+	static FScenarioNodeCache& Get();
+
+	/**
+	* Scenes of the node in row order.
+	* Returned array stays valid after invalidation of the node,
+	* but it will not reflect further changes of the data table.
+	*
+	* @param Node data table based on FScenario
+	* @return scenes of the node
+	*/
+	TSharedRef<const TArray<FScenario*>> GetScenes(const UDataTable* Node);
+
+	/**
+	* @param Node data table based on FScenario
+	* @param Index position of the scene in the node
+	* @return scene at given position or nullptr for invalid index
+	*/
+	FScenario* GetSceneAt(const UDataTable* Node, int32 Index);
+
+	/**
+	* @param Node data table based on FScenario
+	* @param Scene row of the node
+	* @return position of the scene in the node or INDEX_NONE
+	*		  when scene is not a row of the node
+	*/
+	int32 FindIndex(const UDataTable* Node, const FScenario* Scene);
+
+	/**
+	* Discards index of the node.
+	* It will be rebuilt on the next lookup.
+	*
+	* @param Node data table which index is outdated
+	*/
+	void Invalidate(const UDataTable* Node);
+
+	/**
+	* Discards all indices.
+	*/
+	void Reset();
+
+private:
+	FScenarioNodeCache() = default;
+
+	/**
+	* Index of the single node.
+	*/
+	struct FNodeEntry
+	{
+		FNodeEntry(const UDataTable* InNode);
+
+		TWeakObjectPtr<const UDataTable> Node;
+
+		TSharedRef<TArray<FScenario*>> Scenes;
+
+		TMap<const FScenario*, int32> Positions;
+
+		FDelegateHandle OnNodeChangedHandle;
+	};
+
+	/**
+	* Finds index of the node or builds a new one.
+	*
+	* @note reference is valid until the next modification of the cache
+	*
+	* @param Node data table to index
+	* @return index of the node
+	*/
+	FNodeEntry& FindOrAdd(const UDataTable* Node);
+
+	/**
+	* Called when indexed data table is changed.
+	*
+	* @param Key key of the changed data table
+	*/
+	void OnNodeChanged(TObjectKey<UDataTable> Key);
+
+	/**
+	* Removes indices of destroyed data tables.
+	*/
+	void RemoveStaleEntries();
+
+private:
+	/**
+	* Indices of nodes.
+	*/
+	TMap<TObjectKey<UDataTable>, FNodeEntry> Entries;
+
+};
@@ -0,0 +1,176 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+#include "UObject/ObjectKey.h"
+
+class FAssetPinTable;
+class UDataTable;
+struct FScenario;
+struct FStreamableHandle;
+
+/**
+* Keeps assets of prepared scenes in memory within the memory budget.
+* Assets of the scenes are pinned in the shared FAssetPinTable, so
+* assets used by several scenes are requested once. When resident assets
+* exceed the budget, scenes with the lowest priority are released first,
+* least recently used among them.
+*
+* @note sizes are estimated by FAssetPinTable once assets are loaded,
+*		assets shared by several scenes are accounted once.
+*		Scenes are identified by their node and position rather than by address,
+*		so scenes of a replaced node never match scenes that are resident.
+*
+* @see UVisualController::PrepareScenes()
+*/
+class VISUALU_API FSceneResidencyCache
+{
+public:
+	/**
+	* @param InPinTable table that pins assets of resident scenes, must outlive this cache
+	* @param InBudget memory budget in bytes
+	*/
+	FSceneResidencyCache(FAssetPinTable& InPinTable, int64 InBudget);
+
+	~FSceneResidencyCache();
+
+	/**
+	* @param InBudget new memory budget in bytes
+	*/
+	void SetBudget(int64 InBudget);
+
+	/**
+	* @return memory budget in bytes
+	*/
+	FORCEINLINE int64 GetBudget() const { return Budget; }
+
+	/**
+	* @return estimated size, in bytes, of resident scene assets
+	*/
+	int64 GetResidentBytes() const;
+
+	/**
+	* @return number of resident scenes
+	*/
+	FORCEINLINE int32 Num() const { return Entries.Num(); }
+
+	/**
+	* Makes scene resident by pinning its assets.
+	* Scene that is resident already keeps the higher of its priorities.
+	*
+	* @param Scene scene to keep in memory
+	* @param Priority scenes with lower priority are released first
+	* @return handle that completes when assets of the scene are loaded, might be null
+	*/
+	TSharedPtr<FStreamableHandle> Add(const FScenario* Scene, int32 Priority);
+
+	/**
+	* Marks resident scene as recently used.
+	*
+	* @param Scene scene to mark
+	* @param Priority new priority of the scene
+	* @return {@code false} when scene is not resident
+	*/
+	bool Touch(const FScenario* Scene, int32 Priority);
+
+	/**
+	* Gives all resident scenes the lowest priority,
+	* so that scenes which are not touched afterwards are released first.
+	*/
+	void DemoteAll();
+
+	/**
+	* @param Scene scene to look for
+	* @return {@code true} when assets of the scene are held by this cache
+	*/
+	bool Contains(const FScenario* Scene) const;
+
+	/**
+	* @param Scene scene to look for
+	* @return {@code true} when the scene is resident and its assets are loaded
+	*/
+	bool IsLoaded(const FScenario* Scene) const;
+
+	/**
+	* Releases scenes until resident assets fit into the budget.
+	* Scenes that are still loading are kept, since their size is unknown.
+	*
+	* @param ProtectedScenes scenes that must not be released
+	* @return number of released scenes
+	*/
+	int32 Trim(TConstArrayView<const FScenario*> ProtectedScenes);
+
+	/**
+	* Releases all scenes.
+	*/
+	void Empty();
+
+	/**
+	* Development only.
+	*
+	* @return debug information about resident scenes
+	*/
+	FString GetDebugString() const;
+
+private:
+	/**
+	* Identifies scene by its node and position.
+	*/
+	struct FSceneKey
+	{
+		explicit FSceneKey(const FScenario* Scene);
+
+		TObjectKey<UDataTable> Owner;
+
+		int32 Index;
+
+		friend uint32 GetTypeHash(const FSceneKey& Key)
+		{
+			return HashCombine(GetTypeHash(Key.Owner), GetTypeHash(Key.Index));
+		}
+
+		FORCEINLINE bool operator==(const FSceneKey& Other) const
+		{
+			return Owner == Other.Owner && Index == Other.Index;
+		}
+	};
+
+	/**
+	* Resident scene.
+	*/
+	struct FResidentScene
+	{
+		/**
+		* Unique assets of the scene pinned in the table.
+		*/
+		TArray<FSoftObjectPath> Paths;
+
+		TSharedPtr<FStreamableHandle> Handle;
+
+		int32 Priority = 0;
+
+		uint64 LastUse = 0;
+	};
+
+	/**
+	* Unpins assets of the scene.
+	*
+	* @param ResidentScene scene to release
+	*/
+	void Release(FResidentScene& ResidentScene);
+
+private:
+	FAssetPinTable& PinTable;
+
+	TMap<FSceneKey, FResidentScene> Entries;
+
+	int64 Budget;
+
+	/**
+	* Monotonic counter that orders uses of the scenes.
+	*/
+	uint64 UseCounter;
+
+};
@@ -7,9 +7,8 @@
 #include "Templates/SubclassOf.h"
 #include "Async/AsyncWork.h"
 #include "Containers/Ticker.h"
-#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
-#include "Containers/Deque.h"
-#endif
+#include "AssetPinTable.h"
+#include "SceneResidencyCache.h"
 #include "VisualController.generated.h"
 
 class UVisualRenderer;
@@ -18,6 +17,7 @@ class DataTable;
 class UWorld;
 class UWidgetComponent;
 class UVisualVersioningSubsystem;
+class UVisualTextBlock;
 struct FStreamableHandle;
 
 /**
@@ -54,6 +54,18 @@ enum class EVisualControllerMode : uint8
 	AutoMoving = 2
 };
 
+/**
+* Describes how UVisualController paces scenes in auto move mode.
+*/
+UENUM(BlueprintType)
+enum class EVisualAutoMovePacing : uint8
+{
+	/*Scenes are requested every UVisualController::AutoMoveDelay seconds*/
+	Fixed = 0,
+	/*Scenes are requested once the line is typed and read, and the scene sound is over*/
+	Reading = 1
+};
+
 namespace UE
 {
 	namespace VisualU
@@ -114,6 +126,9 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnFastMoveStart, EVisualControllerD
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnFastMoveEnd);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnAutoMoveStart, EVisualControllerDirection::Type, Direction);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnAutoMoveEnd);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnScenePending, EVisualControllerDirection::Type, Direction);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInitializationProgress, float, Progress);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnControllerReady);
 
 /**
  * Organizes scenes described by FScenario in a meaningful way.
@@ -167,6 +182,11 @@ public:
 
 	/**
 	* Visualizes the next scene in the node.
+	* Unless controller advances synchronously, scene is visualized
+	* once its assets are loaded, controller is pending until then.
+	* 
+	* @see UVisualController::IsScenePending()
+	*	   UVisualController::bSynchronousAdvance
 	* 
 	* @return result of the request
 	*/
@@ -176,6 +196,11 @@ public:
 	/**
 	* Visualizes the previous scene in the node.
 	* Can also display last exhausted scene from previous node.
+	* Unless controller advances synchronously, scene is visualized
+	* once its assets are loaded, controller is pending until then.
+	* 
+	* @see UVisualController::IsScenePending()
+	*	   UVisualController::bSynchronousAdvance
 	* 
 	* @return result of the request
 	*/
@@ -243,6 +268,9 @@ public:
 	* in the specified direction as fast as possible.
 	* This mode will end when UVisualController::Head is reached or
 	* scene with EScenarioMetaFlags::Choice is encountered.
+	* When UVisualController::bSkipIntermediateScenes is set, controller
+	* jumps straight to the scene where fast move would end, backward
+	* fast move ends at the start of the node in this case.
 	* 
 	* @note scene transitions are disabled in this mode
 	* 
@@ -255,7 +283,8 @@ public:
 	/**
 	* Tries to activate auto move.
 	* In this mode, controller will request scenes
-	* at the pace of UVisualController::AutoMoveDelay.
+	* at the pace of UVisualController::AutoMoveDelay or,
+	* with EVisualAutoMovePacing::Reading, once the current scene is read.
 	* This mode will end when scene with
 	* EScenarioMetaFlags::Choice is encountered.
 	* 
@@ -268,6 +297,15 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Flow control")
 	bool RequestAutoMove(EVisualControllerDirection::Type Direction = EVisualControllerDirection::Forward);
 
+	/**
+	* Abandons the scene that is waiting for its assets.
+	* Current scene remains visualized.
+	* 
+	* @see UVisualController::IsScenePending()
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Flow control")
+	void CancelPendingScene();
+
 	/**
 	* Ends fast move mode when it is active.
 	* controller becomes idle.
@@ -346,6 +384,112 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Async", meta = (DisplayName = "GetNumScenariosToLoad"))
 	FORCEINLINE int32 GetNumScenesToLoad() const { return ScenesToLoad; };
 
+	/**
+	* Setter for UVisualController::SceneMemoryBudget.
+	* 
+	* @param Megabytes memory budget for assets of prepared scenes
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Async")
+	void SetSceneMemoryBudget(int32 Megabytes);
+
+	/**
+	* @return memory budget, in megabytes, for assets of prepared scenes
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Async")
+	FORCEINLINE int32 GetSceneMemoryBudget() const { return SceneMemoryBudget; }
+
+	/**
+	* Setter for UVisualController::ChoiceScenesToLoad.
+	* 
+	* @param Num number of scenes to load for each choice option
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Async", meta = (DisplayName = "SetNumChoiceScenariosToLoad"))
+	void SetNumChoiceScenesToLoad(int32 Num);
+
+	/**
+	* @return number of scenes to load for each choice option
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Async", meta = (DisplayName = "GetNumChoiceScenariosToLoad"))
+	FORCEINLINE int32 GetNumChoiceScenesToLoad() const { return ChoiceScenesToLoad; }
+
+	/**
+	* Setter for UVisualController::bSkipIntermediateScenes.
+	* 
+	* @param bShouldSkip {@code true} to visualize only the scene where fast move ends
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Flow control")
+	void ShouldSkipIntermediateScenes(bool bShouldSkip);
+
+	/**
+	* @return decision of this controller to visualize only the scene where fast move ends
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Flow control")
+	FORCEINLINE bool SkipsIntermediateScenes() const { return bSkipIntermediateScenes; }
+
+	/**
+	* Setter for UVisualController::SkipFeedbackInterval.
+	* 
+	* @param Interval number of skipped scenes between visualized ones, zero to visualize only the last one
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Flow control")
+	void SetSkipFeedbackInterval(int32 Interval);
+
+	/**
+	* @return number of skipped scenes between visualized ones
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Flow control")
+	FORCEINLINE int32 GetSkipFeedbackInterval() const { return SkipFeedbackInterval; }
+
+	/**
+	* Setter for UVisualController::bAdaptiveScenesToLoad.
+	* 
+	* @param bShouldAdapt {@code true} to resize number of scenes to load
+	*		 based on load time and advance rate
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Async", meta = (DisplayName = "SetAdaptiveScenariosToLoad"))
+	void SetAdaptiveScenesToLoad(bool bShouldAdapt);
+
+	/**
+	* @return {@code true} when number of scenes to load is resized at runtime
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Async", meta = (DisplayName = "IsScenariosToLoadAdaptive"))
+	FORCEINLINE bool IsScenesToLoadAdaptive() const { return bAdaptiveScenesToLoad; }
+
+	/**
+	* Sets bounds for the adaptive number of scenes to load.
+	* 
+	* @param Min lowest number of scenes to load, at least one
+	* @param Max highest number of scenes to load, at least Min
+	* 
+	* @see UVisualController::bAdaptiveScenesToLoad
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Async", meta = (DisplayName = "SetScenariosToLoadBounds"))
+	void SetScenesToLoadBounds(int32 Min, int32 Max);
+
+	/**
+	* Ratio of requested scenes that were already loaded
+	* to all requested scenes.
+	* 
+	* @return prefetch hit rate in [0, 1] range, one when nothing was requested yet
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Async")
+	float GetPrefetchHitRate() const;
+
+	/**
+	* Setter for UVisualController::bSynchronousAdvance.
+	* 
+	* @param bShouldAdvance {@code true} to block until assets of
+	*		 the requested scene are loaded
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Async")
+	void ShouldAdvanceSynchronously(bool bShouldAdvance);
+
+	/**
+	* @return decision of this controller to block until assets of the requested scene are loaded
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Async")
+	FORCEINLINE bool AdvancesSynchronously() const { return bSynchronousAdvance; }
+
 	/**
 	* Setter for UVisualController::bPlayTransitions.
 	* Calling this during fast moving mode is discouraged because
@@ -392,6 +536,44 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Flow control")
 	FORCEINLINE float GetAutoMoveDelay() const { return AutoMoveDelay; }
 
+	/**
+	* Setter for UVisualController::AutoMovePacing.
+	* Takes effect on the next auto move request.
+	* 
+	* @param Pacing new pacing of the auto move mode
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Flow control")
+	void SetAutoMovePacing(EVisualAutoMovePacing Pacing);
+
+	/**
+	* @return pacing of the auto move mode
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Flow control")
+	FORCEINLINE EVisualAutoMovePacing GetAutoMovePacing() const { return AutoMovePacing; }
+
+	/**
+	* Setter for UVisualController::AutoMoveTimePerCharacter.
+	* 
+	* @param Time reading time, in seconds, of a single character of the line
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Flow control")
+	void SetAutoMoveTimePerCharacter(float Time);
+
+	/**
+	* @return reading time, in seconds, of a single character of the line
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Flow control")
+	FORCEINLINE float GetAutoMoveTimePerCharacter() const { return AutoMoveTimePerCharacter; }
+
+	/**
+	* Sets text block that types lines of the scenes.
+	* Auto move with EVisualAutoMovePacing::Reading waits for its typewriter to finish.
+	* 
+	* @param TextBlock text block to wait for, nullptr to not wait for typewriter
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Flow control")
+	void SetAutoMoveTextBlock(UVisualTextBlock* TextBlock);
+
 	/**
 	* @return currently visualized scene.
 	*/
@@ -448,6 +630,58 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Flow control")
 	bool IsTransitioning() const;
 
+	/**
+	* Is controller waiting for assets of the requested scene.
+	* Adjacent scene requests are rejected until it is visualized.
+	* 
+	* @return {@code true} when requested scene is not visualized yet
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Flow control")
+	FORCEINLINE bool IsScenePending() const { return PendingSceneHandle.IsValid(); }
+
+	/**
+	* Is the first scene visualized.
+	* Scene requests are rejected until controller is ready.
+	* 
+	* @return {@code true} when controller is initialized
+	* 
+	* @see UVisualController::bInitializeAsynchronously
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Async")
+	FORCEINLINE bool IsReady() const { return bIsReady; }
+
+	/**
+	* Is there a state to save.
+	* Controller that is still initializing has no current scene yet.
+	* State that is still loading is saved as it was read.
+	* 
+	* @return {@code true} when controller can be saved
+	* 
+	* @see UVisualController::SerializeController()
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Async")
+	bool CanSave() const;
+
+	/**
+	* Are nodes of the loaded save still loading.
+	* Loaded state is applied once they are in memory.
+	* 
+	* @return {@code true} when loaded state is not applied yet
+	* 
+	* @see UVisualController::bLoadAsynchronously
+	*	   UVisualController::OnSavedScenesLoaded
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Async")
+	bool IsLoadingSavedScenes() const;
+
+	/**
+	* @return progress of the initialization in [0, 1] range
+	* 
+	* @see UVisualController::bInitializeAsynchronously
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Async")
+	FORCEINLINE float GetInitializationProgress() const { return InitializationProgress; }
+
 	/**
 	* @return {@code true} when current scene is UVisualController::Head
 	*/
@@ -507,7 +741,7 @@ public:
 	* 
 	* @return debug information about asynchronous scene preparation
 	* 
-	* @see UVisualController::DebugSceneHandles
+	* @see UVisualController::SceneResidency
 	*/
 	UFUNCTION(BlueprintCallable, Category = "Visual Controller|Debug", meta = (DevelopmentOnly))
 	const FString GetAsyncQueueDebugString() const;
@@ -564,6 +798,37 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Visual Controller|Events")
 	FOnAutoMoveEnd OnAutoMoveEnd;
 
+	/**
+	* Called when requested scene waits for its assets to load.
+	* UVisualController::OnSceneStart is called once the scene is visualized.
+	* 
+	* @param Direction direction of the requested scene
+	*/
+	UPROPERTY(BlueprintAssignable, Category = "Visual Controller|Events")
+	FOnScenePending OnScenePending;
+
+	/**
+	* Called when assets of the first node and scene are loading.
+	* 
+	* @param Progress progress of the initialization in [0, 1] range
+	*/
+	UPROPERTY(BlueprintAssignable, Category = "Visual Controller|Events")
+	FOnInitializationProgress OnInitializationProgress;
+
+	/**
+	* Called once the first scene is visualized and controller accepts scene requests.
+	*/
+	UPROPERTY(BlueprintAssignable, Category = "Visual Controller|Events")
+	FOnControllerReady OnControllerReady;
+
+	/**
+	* Native only.
+	* Called once the loaded state is applied, after nodes of the saved scenes are loaded.
+	* 
+	* @see UVisualController::IsLoadingSavedScenes()
+	*/
+	FSimpleMulticastDelegate OnSavedScenesLoaded;
+
 protected:
 	/**
 	* Asynchronously loads assets of the scene into the memory.
@@ -588,13 +853,71 @@ protected:
 	TSharedPtr<FStreamableHandle> LoadScene(const FScenario* Scene, FStreamableDelegate AfterLoadDelegate = nullptr);
 
 	/**
-	* Asynchronously loads assets of future scenes after controller moves.
-	* Has no effect when UVisualController::NumScenesToLoad is less than zero.
+	* Asynchronously loads assets of the next scene and
+	* UVisualController::ScenesToLoad scenes after it.
+	* Prepared scenes stay resident while they fit into
+	* UVisualController::SceneMemoryBudget, current and next scenes are never released.
+	* Has no effect when UVisualController::NumScenesToLoad is zero.
 	* 
 	* @param Direction determines where future scenes are
 	*/
 	void PrepareScenes(EVisualControllerDirection::Type Direction = EVisualControllerDirection::Forward);
 
+	/**
+	* Asynchronously loads first scenes of every FScenario::ChoiceTargets
+	* node of the current scene. Releases previously prepared choice options
+	* when current scene has no choice.
+	* 
+	* @see UVisualController::ChoiceScenesToLoad
+	*/
+	void PrepareChoiceScenes();
+
+	/**
+	* Releases handles for assets of the choice options.
+	*/
+	void CancelChoiceScenes();
+
+	/**
+	* @param Scene scenario to check
+	* @return {@code true} when all assets of the scene are in memory
+	*/
+	bool IsSceneLoaded(const FScenario* Scene) const;
+
+	/**
+	* Accounts the adjacent scene request as prefetch hit or miss.
+	* 
+	* @param Direction determines what is the adjacent scene
+	*/
+	void TrackPrefetch(EVisualControllerDirection::Type Direction);
+
+	/**
+	* Makes the scene resident and waits for its assets.
+	* Assets are pinned in UVisualController::AssetPins, so assets
+	* that are resident or requested already are not requested again.
+	* 
+	* @note returned handle waits on the resident scene, it is reset rather than canceled,
+	*		since canceling it would cancel assets of the resident scene
+	* 
+	* @param Scene scene to make resident
+	* @param Priority priority of the scene in UVisualController::SceneResidency
+	* @return handle that completes when assets of the scene are loaded, nullptr when they are loaded already
+	*/
+	TSharedPtr<FStreamableHandle> PinScene(const FScenario* Scene, int32 Priority);
+
+	/**
+	* Accounts time it took to load prepared scene.
+	* 
+	* @param SceneHandle handle of the prepared scene
+	*/
+	void TrackSceneLoadTime(const TSharedPtr<FStreamableHandle>& SceneHandle);
+
+	/**
+	* Resizes UVisualController::ScenesToLoad so that prepared scenes
+	* are loaded before the player reaches them.
+	* Has no effect unless UVisualController::bAdaptiveScenesToLoad is set.
+	*/
+	void AdaptScenesToLoad();
+
 	/**
 	* Plays the scene sound when available.
 	* Will fail when scene sound is invalid or controller doesn't play sound.
@@ -606,7 +929,8 @@ protected:
 	void TryPlaySceneSound(TSoftObjectPtr<USoundBase> SceneSound) const;
 
 	/**
-	* Releases the handle for the assets of the next scene.
+	* Releases the handle for the assets of the next scene
+	* and cancels its pre-drawing.
 	* 
 	* @see UVisualController::NextSceneHandle
 	*/
@@ -634,6 +958,15 @@ protected:
 	*/
 	UVisualVersioningSubsystem* TryGetVisualVersioningSubsystem() const;
 
+	/**
+	* Applies versions of the node that were loaded lazily.
+	*
+	* @param DataTable node that is entered or prepared
+	* 
+	* @see UVisualVersioningSubsystem::RestoreVersions
+	*/
+	void RestoreVersions(const UDataTable* DataTable) const;
+
 	/**
 	* Guarantees that the next requested scene assets will be loaded.
 	* 
@@ -643,7 +976,163 @@ protected:
 	*/
 	void AssertNextSceneLoad(EVisualControllerDirection::Type Direction = EVisualControllerDirection::Forward);
 
+	/**
+	* Visualizes the next scene as soon as its assets are loaded.
+	* Controller is pending when assets are not loaded yet.
+	* 
+	* @param Direction determines what is the next scene
+	* 
+	* @see UVisualController::IsScenePending()
+	*/
+	void AwaitNextSceneLoad(EVisualControllerDirection::Type Direction = EVisualControllerDirection::Forward);
+
+	/**
+	* Builds the adjacent scene in the hidden buffer of the renderer once its assets are loaded,
+	* so that advancing to it only swaps the buffers.
+	* Does nothing unless renderer is double buffered.
+	* 
+	* @param Direction determines what is the adjacent scene
+	* 
+	* @see UVisualRenderer::PreDrawScene
+	*/
+	void PreDrawAdjacentScene(EVisualControllerDirection::Type Direction);
+
+	/**
+	* Waits until the current scene is read, then requests the adjacent scene.
+	* Reading time is the longest of the line reading time, scene sound duration
+	* and duration of the transition into the scene, if one plays.
+	* Rich text tags of the line are not counted. Line is also expected to be typed by
+	* UVisualController::AutoMoveTextBlock.
+	* 
+	* @see EVisualAutoMovePacing::Reading
+	*/
+	void ScheduleAutoMove();
+
+	/**
+	* Requests the adjacent scene in auto move mode once
+	* current scene is read and its line is typed.
+	*/
+	void TryAutoMove();
+
+	/**
+	* Checks whether auto move can go past the requested scene.
+	* Requested scene may still be pending, while scene index points to the previous one.
+	* 
+	* @param Direction direction of the auto move
+	* @return {@code true} when there is a scene after the requested one
+	*/
+	bool CanContinueAutoMove(EVisualControllerDirection::Type Direction) const;
+
+	/**
+	* Called when UVisualController::AutoMoveTextBlock finishes typing.
+	*/
+	UFUNCTION()
+	void OnAutoMoveLineTyped();
+
+	/**
+	* Finds the scene where fast move in provided direction ends.
+	* Moving forward, that is UVisualController::Head, scene with a choice
+	* or the last scene of the node. Moving backward, that is the first scene of the node.
+	* 
+	* @param Direction direction of the fast move
+	* @return position of the scene in the node
+	*/
+	int32 FindFastMoveTarget(EVisualControllerDirection::Type Direction) const;
+
+	/**
+	* Fast moves by skipping intermediate scenes.
+	* 
+	* @param Direction direction of the fast move
+	* @return result of the request
+	* 
+	* @see UVisualController::bSkipIntermediateScenes
+	*/
+	bool SkipFastMove(EVisualControllerDirection::Type Direction);
+
+	/**
+	* Switches controller to the scene in the current node, skipping scenes in between.
+	* Only provided scene is loaded and visualized.
+	* 
+	* @param TargetIndex position of the scene to switch to
+	*/
+	void SkipTo(int32 TargetIndex);
+
+	/**
+	* Switches controller to the scene adjacent to the current one and visualizes it.
+	* Assets of the scene are expected to be loaded.
+	* 
+	* @param Direction determines what is the adjacent scene
+	*/
+	void ShowAdjacentScene(EVisualControllerDirection::Type Direction);
+
+	/**
+	* Creates renderer and visualizes the first scene,
+	* asynchronously when UVisualController::bInitializeAsynchronously is set.
+	*/
+	void Initialize();
+
+	/**
+	* Loads the first node through the streamable manager.
+	* Node from the story pack is used right away.
+	*/
+	void InitializeAsync();
+
+	/**
+	* Makes the first scene of the loaded first node current
+	* and loads its assets asynchronously.
+	*/
+	void OnFirstNodeLoaded();
+
+	/**
+	* Makes the first scene of the node current.
+	* 
+	* @param FirstNode node specified by UVisualUSettings::FirstDataTable
+	*/
+	void SetFirstNode(const UDataTable* FirstNode);
+
+	/**
+	* Visualizes the first scene and marks controller as ready.
+	*/
+	void FinishInitialization();
+
+	/**
+	* Stops loading of the first node and scene.
+	*/
+	void CancelInitialization();
+
+	/**
+	* Reports progress of the initialization.
+	* 
+	* @param Progress progress in [0, 1] range
+	*/
+	void SetInitializationProgress(float Progress);
+
+	/**
+	* Requests nodes of the saved scenes in one batch,
+	* state of the controller is restored once they are loaded.
+	* 
+	* @see UVisualController::bLoadAsynchronously
+	*/
+	void LoadSavedScenesAsync();
+
+	/**
+	* Resolves saved scenes and restores the state of the controller.
+	* Nodes that are not loaded yet are loaded synchronously.
+	* 
+	* @param bWasReady whether or not controller was ready before the load
+	*/
+	void FinishLoadingSavedScenes(bool bWasReady);
+
 private:
+	/**
+	* Position of the scene read from the save, its node might not be loaded yet.
+	*/
+	struct FSavedScene
+	{
+		FSoftObjectPath Owner;
+		int32 Index = INDEX_NONE;
+	};
+
 	/**
 	* Responsible for visualizing scenes as widgets.
 	* 
@@ -658,11 +1147,53 @@ private:
 	TSharedPtr<FStreamableHandle> NextSceneHandle;
 
 	/**
-	* Currently active data table with scenes.
+	* Handle that waits for resident assets of the requested scene.
+	* 
+	* @see UVisualController::IsScenePending()
+	*/
+	TSharedPtr<FStreamableHandle> PendingSceneHandle;
+
+	/**
+	* Handle that waits for resident assets of the scene that will be pre-drawn by the renderer.
+	* 
+	* @see UVisualController::PreDrawAdjacentScene
+	*/
+	TSharedPtr<FStreamableHandle> PreDrawHandle;
+
+	/**
+	* Handle for the first node or assets of the first scene during initialization,
+	* or for the nodes of the saved scenes during load.
+	*/
+	TSharedPtr<FStreamableHandle> InitializationHandle;
+
+	/**
+	* Scenes read from the save that wait for their nodes:
+	* exhausted scenes, current scene and head, in that order.
+	*/
+	TArray<FSavedScene> SavedScenes;
+
+	/**
+	* Handle for the nodes listed in FScenario::ChoiceTargets of the current scene.
+	*/
+	TSharedPtr<FStreamableHandle> ChoiceTargetsHandle;
+
+	/**
+	* Handles that wait for resident assets of the first scenes of choice options.
+	*/
+	TArray<TSharedPtr<FStreamableHandle>> ChoiceSceneHandles;
+
+	/**
+	* Scene which choice options are prepared.
+	*/
+	const FScenario* PreparedChoice;
+
+	/**
+	* Scenes of the currently active data table.
 	* 
 	* @see FScenario
+	*	   FScenarioNodeCache
 	*/
-	TArray<FScenario*> Node;
+	TSharedPtr<const TArray<FScenario*>> Node;
 
 	/**
 	* Position of the current scene.
@@ -670,25 +1201,20 @@ private:
 	int32 SceneIndex;
 
 	/**
-	* Handles for resources of the following scenes.
+	* Assets of the prepared scenes, each requested once regardless
+	* of how many prepared scenes use it.
 	* 
-	* @note number of elements is always
-	*		less or equal to UVisualController::ScenesToLoad.
+	* @note declared before UVisualController::SceneResidency which relies on it
 	*/
-	TQueue<TSharedPtr<FStreamableHandle>> SceneHandles;
+	FAssetPinTable AssetPins;
 
-#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 	/**
-	* Additional debug queue that gathers weak references to scenes
-	* that are meant to be loaded asynchronously.
+	* Holds resources of the prepared scenes within
+	* UVisualController::SceneMemoryBudget.
 	* 
-	* @note isn't present in shipping or test builds
-	* 
-	* @see UVisualController::SceneHandles
-	*		   UVisualController::PrepareScenes()
+	* @see UVisualController::PrepareScenes()
 	*/
-	TDeque<TWeakPtr<FStreamableHandle>> DebugSceneHandles{};
-#endif
+	FSceneResidencyCache SceneResidency;
 
 	/**
 	* Maintains references to all data tables that
@@ -705,6 +1231,12 @@ private:
 	*/
 	TArray<FScenario*> ExhaustedScenes;
 
+	/**
+	* Positions of exhausted nodes in UVisualController::ExhaustedScenes.
+	* Allows to find requested node without traversing the stack.
+	*/
+	TMap<const UDataTable*, int32> ExhaustedNodePositions;
+
 	/**
 	* So far, the deepest scene in Visual Controller.
 	* It does not account for parallel branches.
@@ -721,6 +1253,13 @@ private:
 	*/
 	TUniquePtr<UE::VisualU::Private::FFastMoveAsyncTask> FastMoveTask;
 
+	/**
+	* Handle to the ticker that visualizes skipped scenes.
+	* 
+	* @see UVisualController::SkipFeedbackInterval
+	*/
+	FTSTicker::FDelegateHandle FastMoveHandle;
+
 	/**
 	* Handle to the ticker that performs auto move.
 	* 
@@ -728,6 +1267,26 @@ private:
 	*/
 	FTSTicker::FDelegateHandle AutoMoveHandle;
 
+	/**
+	* Direction of the active auto move.
+	*/
+	EVisualControllerDirection::Type AutoMoveDirection;
+
+	/**
+	* Has current scene been shown long enough to be read.
+	* 
+	* @see UVisualController::ScheduleAutoMove()
+	*/
+	bool bIsSceneRead;
+
+	/**
+	* Text block that types lines of the scenes.
+	* 
+	* @see UVisualController::SetAutoMoveTextBlock()
+	*/
+	UPROPERTY(Transient)
+	TWeakObjectPtr<UVisualTextBlock> AutoMoveTextBlock;
+
 	/**
 	* How many following scenes will be loaded asynchronously.
 	* Zero means no asynchronous loading.
@@ -738,6 +1297,146 @@ private:
 	UPROPERTY(EditAnywhere, SaveGame, BlueprintReadOnly, Category = "Visual Controller|Async", meta = (AllowPrivateAccess = true, UIMin = 0.f, ClampMin = 0.f, ToolTip = "How many following scenes will be loaded asynchronously. Zero means no asynchronous loading."))
 	int32 ScenesToLoad;
 
+	/**
+	* Memory budget, in megabytes, for assets of the prepared scenes.
+	* Scenes with lowest priority, least recently used among them,
+	* are released when budget is exceeded.
+	* 
+	* @note current and next scenes are kept regardless of the budget
+	* 
+	* @see UVisualController::SceneResidency
+	*/
+	UPROPERTY(EditAnywhere, SaveGame, BlueprintReadOnly, Category = "Visual Controller|Async", meta = (AllowPrivateAccess = true, UIMin = 1, ClampMin = 1, Units = "Megabytes", ToolTip = "Memory budget for assets of the prepared scenes. Current and next scenes are kept regardless of the budget."))
+	int32 SceneMemoryBudget;
+
+	/**
+	* How many first scenes of each choice option will be loaded
+	* asynchronously while the choice is visualized.
+	* Zero means choice options are not prepared.
+	* 
+	* @see FScenario::ChoiceTargets
+	*/
+	UPROPERTY(EditAnywhere, SaveGame, BlueprintReadOnly, Category = "Visual Controller|Async", meta = (AllowPrivateAccess = true, UIMin = 0.f, ClampMin = 0.f, ToolTip = "How many first scenes of each choice option will be loaded asynchronously while the choice is visualized. Zero means no asynchronous loading."))
+	int32 ChoiceScenesToLoad;
+
+	/**
+	* Should fast move jump straight to the scene where it ends.
+	* Skipped scenes are not loaded nor visualized,
+	* their sound is not played and no events are called for them.
+	* 
+	* @see UVisualController::RequestFastMove()
+	*	   UVisualController::SkipFeedbackInterval
+	*/
+	UPROPERTY(EditAnywhere, SaveGame, BlueprintReadOnly, Category = "Visual Controller|Flow control", meta = (AllowPrivateAccess = true, ToolTip = "Should fast move jump straight to the scene where it ends without visualizing scenes in between"))
+	bool bSkipIntermediateScenes;
+
+	/**
+	* How many scenes are skipped between visualized ones
+	* when fast move skips intermediate scenes, one step per frame.
+	* Zero means only the scene where fast move ends is visualized.
+	* 
+	* @see UVisualController::bSkipIntermediateScenes
+	*/
+	UPROPERTY(EditAnywhere, SaveGame, BlueprintReadOnly, Category = "Visual Controller|Flow control", meta = (AllowPrivateAccess = true, EditCondition = "bSkipIntermediateScenes", UIMin = 0, ClampMin = 0, ToolTip = "How many scenes are skipped between visualized ones, one step per frame. Zero means only the scene where fast move ends is visualized."))
+	int32 SkipFeedbackInterval;
+
+	/**
+	* Should controller block until assets of the requested scene are loaded.
+	* Otherwise, controller is pending until the scene can be visualized.
+	* 
+	* @note blocking load might cause a hitch when scene was not prepared in time
+	* 
+	* @see UVisualController::PrepareScenes()
+	*/
+	UPROPERTY(EditAnywhere, SaveGame, BlueprintReadOnly, Category = "Visual Controller|Async", meta = (AllowPrivateAccess = true, ToolTip = "Should Visual Controller block until assets of the requested scene are loaded. Otherwise, scene is visualized once its assets are loaded."))
+	bool bSynchronousAdvance;
+
+	/**
+	* Should controller load the first node and scene asynchronously.
+	* Otherwise, game thread is blocked until the first scene is visualized.
+	* 
+	* @note scene requests are rejected until controller is ready
+	* 
+	* @see UVisualController::IsReady()
+	*	   UVisualController::OnInitializationProgress
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Visual Controller|Async", meta = (AllowPrivateAccess = true, ToolTip = "Should Visual Controller load the first node and scene asynchronously. Scene requests are rejected until controller is ready."))
+	bool bInitializeAsynchronously;
+
+	/**
+	* Should controller load nodes of the saved scenes in one asynchronous batch.
+	* Otherwise, every node is loaded synchronously while reading the save.
+	* 
+	* @note scene requests are rejected until controller is ready
+	* 
+	* @see UVisualController::IsReady()
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Visual Controller|Async", meta = (AllowPrivateAccess = true, ToolTip = "Should Visual Controller load nodes of the saved scenes in one asynchronous batch. Scene requests are rejected until controller is ready."))
+	bool bLoadAsynchronously;
+
+	/**
+	* Is the first scene visualized.
+	*/
+	bool bIsReady;
+
+	/**
+	* Progress of the initialization in [0, 1] range.
+	*/
+	float InitializationProgress;
+
+	/**
+	* Time when initialization has started, in seconds.
+	*/
+	double InitializationStartTime;
+
+	/**
+	* Should controller resize UVisualController::ScenesToLoad at runtime.
+	* Number of scenes to load follows average load time of a scene
+	* divided by average time between scene requests.
+	* 
+	* @see UVisualController::MinScenesToLoad
+	*	   UVisualController::MaxScenesToLoad
+	*/
+	UPROPERTY(EditAnywhere, SaveGame, BlueprintReadOnly, Category = "Visual Controller|Async", meta = (AllowPrivateAccess = true, ToolTip = "Should Visual Controller resize number of scenes to load based on measured load time and advance rate"))
+	bool bAdaptiveScenesToLoad;
+
+	/**
+	* Lowest number of scenes to load in adaptive mode.
+	*/
+	UPROPERTY(EditAnywhere, SaveGame, BlueprintReadOnly, Category = "Visual Controller|Async", meta = (AllowPrivateAccess = true, EditCondition = "bAdaptiveScenesToLoad", UIMin = 1, ClampMin = 1, ToolTip = "Lowest number of scenes to load in adaptive mode"))
+	int32 MinScenesToLoad;
+
+	/**
+	* Highest number of scenes to load in adaptive mode.
+	*/
+	UPROPERTY(EditAnywhere, SaveGame, BlueprintReadOnly, Category = "Visual Controller|Async", meta = (AllowPrivateAccess = true, EditCondition = "bAdaptiveScenesToLoad", UIMin = 1, ClampMin = 1, ToolTip = "Highest number of scenes to load in adaptive mode"))
+	int32 MaxScenesToLoad;
+
+	/**
+	* Exponential moving average of the prepared scene load time, in seconds.
+	*/
+	double AverageSceneLoadTime;
+
+	/**
+	* Exponential moving average of time between scene requests, in seconds.
+	*/
+	double AverageAdvanceInterval;
+
+	/**
+	* Time of the last visualized adjacent scene.
+	*/
+	double LastAdvanceTime;
+
+	/**
+	* Number of requested scenes that were already loaded.
+	*/
+	int32 PrefetchHits;
+
+	/**
+	* Number of requested scenes that had to wait for their assets.
+	*/
+	int32 PrefetchMisses;
+
 	/**
 	* Should controller attempt to play transitions between scenes.
 	* Changes to this value during fast moving mode
@@ -769,6 +1468,21 @@ private:
 	UPROPERTY(EditAnywhere, SaveGame, BlueprintReadOnly, Category = "Visual Controller|Flow control", meta = (AllowPrivateAccess = true, UIMin = 0.f, ClampMin = 0.f, ToolTip = "How long, in seconds, Visual Controller should wait before moving to the next scene in Auto Move mode. Must be larger than transition duration to not stop on transitions. Warning: don't put a zero to simulate fast forwarding, use FastMove instead."))
 	float AutoMoveDelay;
 
+	/**
+	* How auto move mode decides when to request the next scene.
+	* 
+	* @see UVisualController::RequestAutoMove()
+	*/
+	UPROPERTY(EditAnywhere, SaveGame, BlueprintReadOnly, Category = "Visual Controller|Flow control", meta = (AllowPrivateAccess = true, ToolTip = "How auto move mode decides when to request the next scene"))
+	EVisualAutoMovePacing AutoMovePacing;
+
+	/**
+	* Reading time, in seconds, of a single character of the line
+	* in auto move mode with EVisualAutoMovePacing::Reading.
+	*/
+	UPROPERTY(EditAnywhere, SaveGame, BlueprintReadOnly, Category = "Visual Controller|Flow control", meta = (AllowPrivateAccess = true, UIMin = 0.f, ClampMin = 0.f, EditCondition = "AutoMovePacing == EVisualAutoMovePacing::Reading", ToolTip = "Reading time, in seconds, of a single character of the line in auto move mode with Reading pacing"))
+	float AutoMoveTimePerCharacter;
+
 	/**
 	* Current state of this controller.
 	* Controller can be fast moving, auto moving, or idle.
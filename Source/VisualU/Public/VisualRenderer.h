@@ -15,6 +15,117 @@ class UMaterialParameterCollection;
 class FTSTicker;
 struct FWidgetAnimationHandle;
 
+/**
+* Hidden sprites of the same class that can be reused by UVisualRenderer.
+*/
+USTRUCT()
+struct FVisualSpritePool
+{
+	GENERATED_BODY()
+
+	/**
+	* Collapsed sprites that are still children of the canvas.
+	*/
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UVisualSprite>> Sprites;
+};
+
+/**
+* Sprite of the scene that waits to be constructed, updated or placed.
+* 
+* @see UVisualUSettings::SpriteConstructionBudget
+*/
+struct FVisualSpriteRequest
+{
+	FVisualSpriteRequest(int32 InIndex, ESlateVisibility InFinalVisibility, bool bInIsNewSprite, bool bInAssignSpriteInfo)
+		: Index(InIndex),
+		FinalVisibility(InFinalVisibility),
+		bIsNewSprite(bInIsNewSprite),
+		bAssignSpriteInfo(bInAssignSpriteInfo),
+		bBroadcastAppear(bInIsNewSprite)
+	{
+	}
+
+	/**
+	* Position of the sprite in FVisualSceneBuffer::Sprites and FVisualSceneBuffer::SpriteData.
+	*/
+	int32 Index;
+
+	/**
+	* Visibility of the sprite once it is placed.
+	*/
+	ESlateVisibility FinalVisibility;
+
+	/**
+	* Whether sprite should be taken from the pool or constructed.
+	*/
+	bool bIsNewSprite;
+
+	/**
+	* Whether sprite info should be assigned to the sprite.
+	*/
+	bool bAssignSpriteInfo;
+
+	/**
+	* Whether UVisualSprite::OnSpriteAppear should be broadcast once the sprite is placed.
+	*/
+	bool bBroadcastAppear;
+};
+
+/**
+* Canvas with sprites of one scene.
+* Double buffered UVisualRenderer builds the next scene in the hidden buffer.
+*/
+USTRUCT()
+struct FVisualSceneBuffer
+{
+	GENERATED_BODY()
+
+	/**
+	* Panel to which sprites of the scene are added.
+	*/
+	UPROPERTY(Transient)
+	TObjectPtr<UCanvasPanel> Canvas = nullptr;
+
+	/**
+	* Sprites of the scene, null for sprites that are not constructed yet.
+	*/
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UVisualSprite>> Sprites;
+
+	/**
+	* Data of the sprites, in the same order as FVisualSceneBuffer::Sprites.
+	* Sprites of the next scene are compared with it, so that unchanged sprites are kept as is.
+	*/
+	TArray<FSprite> SpriteData;
+
+	/**
+	* Hidden sprites by their class, reused instead of constructing new widgets.
+	*/
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UClass>, FVisualSpritePool> SpritePools;
+
+	/**
+	* Scene that was built in this buffer, only used for comparison.
+	*/
+	const FScenario* Scene = nullptr;
+
+	/**
+	* Sprites that are not constructed or updated yet, in order of their ZOrder.
+	*/
+	TArray<FVisualSpriteRequest> PendingSprites;
+
+	/**
+	* Sprites that wait for layout to be placed.
+	*/
+	TArray<FVisualSpriteRequest> SpritesToPlace;
+
+	/**
+	* Handle to the processing of sprites deferred to the next frames.
+	*/
+	FTSTicker::FDelegateHandle DrawHandle;
+};
+
 /**
  * Responsible for visualizing data from described by FScenario.
  * Renderer supports custom transitions between scene backgrounds that are
@@ -33,11 +144,36 @@ public:
 
 	/**
 	* Assembles widgets for the scene.
+	* Sprites of the drawn scene are matched with sprites of the new one
+	* by class and occurrence of the class. Matched sprites are reused and
+	* only changed data is applied to them, other sprites are released.
+	* Sprites are laid out and placed in the same frame, unless their
+	* Slate widgets are not constructed yet or construction exceeds the frame budget.
+	* Scene that was pre-drawn is shown by swapping the buffers.
 	* 
 	* @param Scene scene to render
+	* 
+	* @see UVisualRenderer::PreDrawScene
 	*/
 	virtual void DrawScene(const FScenario* Scene);
 
+	/**
+	* Builds sprites of the scene in the hidden buffer,
+	* so that drawing it later only swaps the buffers.
+	* Does nothing unless renderer is double buffered.
+	* During transition the scene is pre-drawn after the final scene is drawn.
+	* 
+	* @param Scene scene that is likely to be drawn next
+	* 
+	* @see UVisualUSettings::bDoubleBufferedRenderer
+	*/
+	void PreDrawScene(const FScenario* Scene);
+
+	/**
+	* @return {@code true} when the next scene can be built while the current one is displayed
+	*/
+	FORCEINLINE bool IsDoubleBuffered() const { return bIsDoubleBuffered; }
+
 	/**
 	* @return {@code true} for ongoing visual transition between secenes
 	* 
@@ -68,6 +204,7 @@ protected:
 	* Constructs underlying slate widget and widgets needed for drawing scenes.
 	* Renderer always has a canvas panel to which visual sprites are added, and
 	* one persistent visual image for scene background.
+	* Double buffered renderer adds sprites to one of two nested canvases instead.
 	* 
 	* @return underlying slate widget
 	* 
@@ -82,7 +219,7 @@ protected:
 	virtual void NativeOnInitialized() override;
 
 	/**
-	* Cancels the last draw request before destructing.
+	* Cancels deferred draw requests before destructing.
 	*/
 	virtual void NativeDestruct() override;
 
@@ -94,13 +231,94 @@ protected:
 	virtual void OnAnimationFinished_Implementation(const UWidgetAnimation* Animation) override;
 
 	/**
-	* Iterates over each UVisualSprite in the canvas panel.
+	* Iterates over each UVisualSprite of the drawn scene.
+	* Pooled sprites and sprites of the hidden buffer are skipped.
 	* 
 	* @param Action callable that will be executed for each sprite
 	*/
 	void ForEachSprite(TFunction<void(UVisualSprite* Sprite)> Action);
 
+	/**
+	* Takes hidden sprite of the class from the pool or constructs a new one.
+	* Sprite is a child of the buffer canvas.
+	* 
+	* @param Buffer buffer of the scene
+	* @param SpriteClass class of the sprite
+	* @return sprite that is not yet added to the buffer sprites
+	*/
+	UVisualSprite* AcquireSprite(FVisualSceneBuffer& Buffer, UClass* SpriteClass);
+
+	/**
+	* Hides sprites of the scene and returns them to their pools.
+	* Sprites that don't fit into the pool are removed.
+	* 
+	* @param Buffer buffer of the scene
+	* 
+	* @see UVisualUSettings::SpritePoolSize
+	*/
+	void ReleaseSprites(FVisualSceneBuffer& Buffer);
+
+	/**
+	* Hides sprite and returns it to the pool, or removes it when the pool is full.
+	* 
+	* @param Buffer buffer of the scene
+	* @param Sprite sprite that is no longer drawn
+	*/
+	void ReleaseSprite(FVisualSceneBuffer& Buffer, UVisualSprite* Sprite);
+
+	/**
+	* @param SpriteClass class of the sprite
+	* @return max number of pooled sprites of the class
+	*/
+	int32 GetSpritePoolSize(const UClass* SpriteClass) const;
+
 private:
+	/**
+	* Matches sprites of the buffer with sprites of the scene,
+	* applies changed data and lays out changed sprites.
+	* 
+	* @param BufferIndex index of the buffer in UVisualRenderer::SceneBuffers
+	* @param Scene scene to build
+	*/
+	void BuildScene(int32 BufferIndex, const FScenario* Scene);
+
+	/**
+	* Constructs and updates pending sprites of the buffer in order of their ZOrder
+	* until the frame budget is spent, then lays out and places processed sprites.
+	* 
+	* @param BufferIndex index of the buffer in UVisualRenderer::SceneBuffers
+	* @return {@code true} when some sprites should be processed on the next frame
+	* 
+	* @see UVisualUSettings::SpriteConstructionBudget
+	*/
+	bool ProcessSpriteRequests(int32 BufferIndex);
+
+	/**
+	* Positions laid out sprite according to its anchors and shows it.
+	* 
+	* @param BufferIndex index of the buffer in UVisualRenderer::SceneBuffers
+	* @param Request processed request of the sprite
+	*/
+	void PlaceSprite(int32 BufferIndex, const FVisualSpriteRequest& Request);
+
+	/**
+	* Drops sprite requests of the buffer that were not processed or placed yet.
+	* Data of such sprites in FVisualSceneBuffer::SpriteData is not applied to them.
+	* 
+	* @param Buffer buffer of the scene
+	* @return cancelled requests
+	*/
+	TArray<FVisualSpriteRequest> CancelSpriteRequests(FVisualSceneBuffer& Buffer);
+
+	/**
+	* Shows the hidden buffer and hides the displayed one.
+	*/
+	void SwapBuffers();
+
+	FORCEINLINE FVisualSceneBuffer& GetFrontBuffer() { return SceneBuffers[FrontBufferIndex]; }
+
+	FORCEINLINE FVisualSceneBuffer& GetBackBuffer() { return SceneBuffers[1 - FrontBufferIndex]; }
+
 	/**
 	* Widget animation used to drive transition between scenes.
 	* It can be configured in UVisualUSettings.
@@ -123,6 +341,12 @@ private:
 	*/
 	const FScenario* FinalScene;
 
+	/**
+	* Scene requested to be pre-drawn during transition.
+	* It is pre-drawn once UVisualRenderer::FinalScene is drawn.
+	*/
+	const FScenario* DeferredPreDrawScene;
+
 	/**
 	* Persistent widget that displays scene background.
 	*/
@@ -131,13 +355,26 @@ private:
 
 	/**
 	* Persistent widget that holds background and all sprites of the scene.
+	* Sprites of double buffered renderer are in nested canvases.
 	*/
 	UPROPERTY()
 	TObjectPtr<UCanvasPanel> Canvas;
 
 	/**
-	* Handle to the latest draw request.
+	* Displayed and hidden scenes. Only the first buffer
+	* is used unless renderer is double buffered.
 	*/
-	FTSTicker::FDelegateHandle DrawHandle;
+	UPROPERTY(Transient)
+	FVisualSceneBuffer SceneBuffers[2];
+
+	/**
+	* Index of the displayed buffer in UVisualRenderer::SceneBuffers.
+	*/
+	int32 FrontBufferIndex;
+
+	/**
+	* Whether renderer was built with two scene buffers.
+	*/
+	bool bIsDoubleBuffered;
 	
 };
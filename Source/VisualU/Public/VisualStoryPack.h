@@ -0,0 +1,253 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataTable.h"
+#include "VisualStoryPack.generated.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+struct FScenario;
+struct FVisualImageInfo;
+
+/**
+* Binary layout of the story pack.
+* All records are plain data, little-endian, and every section is 8-byte aligned.
+* Strings are UTF-8 and referenced by index, soft paths are indices of strings.
+*/
+namespace UE::VisualU::StoryPack
+{
+	/*"VSPK"*/
+	constexpr uint32 Magic = 0x4B505356;
+
+	constexpr uint32 Version = 1;
+
+	/*Absent string, path or text*/
+	constexpr uint32 None = MAX_uint32;
+
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint32 NumStrings;
+		uint32 StringsOffset;
+		uint32 StringDataSize;
+		uint32 StringDataOffset;
+		uint32 NumPaths;
+		uint32 PathsOffset;
+		uint32 NumNodes;
+		uint32 NodesOffset;
+		uint32 NumScenes;
+		uint32 ScenesOffset;
+		uint32 NumSprites;
+		uint32 SpritesOffset;
+		uint32 NumImages;
+		uint32 ImagesOffset;
+		uint32 NumChoiceTargets;
+		uint32 ChoiceTargetsOffset;
+	};
+
+	struct FStringRecord
+	{
+		uint32 Offset;
+		uint32 Length;
+	};
+
+	struct FTextRecord
+	{
+		uint32 Namespace;
+		uint32 Key;
+		uint32 Source;
+	};
+
+	struct FImageRecord
+	{
+		double DesiredScale[2];
+		double MirrorScale[2];
+		float ColorAndOpacity[4];
+		uint32 Expression;
+		int32 FrameIndex;
+		uint8 bAnimate;
+		uint8 Padding[7];
+	};
+
+	struct FSpriteRecord
+	{
+		double Anchors[4];
+		double Position[2];
+		int32 ZOrder;
+		uint32 SpriteClass;
+		uint32 FirstImage;
+		uint32 NumImages;
+	};
+
+	struct FSceneRecord
+	{
+		FImageRecord BackgroundArt;
+		FTextRecord Author;
+		FTextRecord Line;
+		uint32 RowName;
+		uint32 Sound;
+		uint32 TransitionMaterial;
+		uint32 FirstSprite;
+		uint32 NumSprites;
+		uint32 FirstChoiceTarget;
+		uint32 NumChoiceTargets;
+		uint8 Flags;
+		uint8 Padding[3];
+	};
+
+	struct FNodeRecord
+	{
+		uint32 Path;
+		uint32 FirstScene;
+		uint32 NumScenes;
+	};
+}
+
+/**
+* Data table created from the story pack.
+* Has the same path as the data table it was compiled from,
+* so soft references and saved scenes resolve to it.
+*
+* @see FVisualStoryPack
+*/
+UCLASS(Transient, MinimalAPI)
+class UVisualStoryPackTable : public UDataTable
+{
+	GENERATED_BODY()
+
+	friend class FVisualStoryPack;
+};
+
+/**
+* Compiled, memory-mapped collection of nodes.
+* Nodes are read from fixed-size records instead of loading data table packages,
+* which avoids package loading and reflection-based serialization of rows.
+* Packed node is created in memory on the first request and used in place of the data table.
+*
+* @note only nodes with exactly FScenario row struct are packed,
+*		other nodes are loaded as data tables.
+*		Pack is not used in the editor.
+*
+* @see UVisualUSettings::bUseStoryPack
+*	   UVisualStoryPackCommandlet
+*/
+class VISUALU_API FVisualStoryPack
+{
+public:
+	~FVisualStoryPack();
+
+	/**
+	* Game thread only.
+	*
+	* @return story pack specified in UVisualUSettings, nullptr when it is disabled or invalid
+	*/
+	static FVisualStoryPack* Get();
+
+	/**
+	* Maps story pack into memory.
+	*
+	* @param Filename path to the story pack
+	* @return story pack or nullptr when file is missing or invalid
+	*/
+	static TUniquePtr<FVisualStoryPack> Open(const FString& Filename);
+
+	/**
+	* Finds node in memory, creates it from the story pack
+	* or loads data table synchronously, in that order.
+	*
+	* @param Path path of the data table
+	* @return node at given path, might be null
+	*/
+	static UDataTable* LoadNode(const FSoftObjectPath& Path);
+
+	/**
+	* @param Path path of the data table
+	* @return {@code true} when the node is in this pack
+	*/
+	bool Contains(const FSoftObjectPath& Path) const;
+
+	/**
+	* Creates node from this pack unless it is already in memory.
+	*
+	* @param Path path of the data table
+	* @return node at given path or nullptr when the node is not packed
+	*/
+	UDataTable* FindOrCreateNode(const FSoftObjectPath& Path) const;
+
+	/**
+	* @return number of nodes in this pack
+	*/
+	FORCEINLINE int32 NumNodes() const { return Nodes.Num(); }
+
+#if WITH_EDITOR
+	/**
+	* Editor only.
+	*
+	* Compiles nodes into the story pack.
+	*
+	* @param InNodes data tables with FScenario row struct
+	* @param OutData story pack data
+	* @return number of packed nodes
+	*/
+	static int32 Write(TConstArrayView<const UDataTable*> InNodes, TArray<uint8>& OutData);
+#endif
+
+private:
+	FVisualStoryPack();
+
+	/**
+	* Checks the header and bounds of all records.
+	*
+	* @return {@code true} when the pack can be read safely
+	*/
+	bool Validate();
+
+	FString GetString(uint32 StringIndex) const;
+
+	FSoftObjectPath GetPath(uint32 PathIndex) const;
+
+	FText GetText(const UE::VisualU::StoryPack::FTextRecord& Record) const;
+
+	void ReadImage(const UE::VisualU::StoryPack::FImageRecord& Record, FVisualImageInfo& OutImageInfo) const;
+
+	void ReadScene(const UE::VisualU::StoryPack::FSceneRecord& Record, FScenario& OutScene) const;
+
+private:
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/**
+	* Contents of the pack when file can't be mapped.
+	*/
+	TArray64<uint8> Buffer;
+
+	const uint8* Data;
+
+	int64 Size;
+
+	TConstArrayView<UE::VisualU::StoryPack::FStringRecord> Strings;
+
+	TConstArrayView<uint8> StringData;
+
+	TConstArrayView<uint32> Paths;
+
+	TConstArrayView<UE::VisualU::StoryPack::FNodeRecord> Nodes;
+
+	TConstArrayView<UE::VisualU::StoryPack::FSceneRecord> Scenes;
+
+	TConstArrayView<UE::VisualU::StoryPack::FSpriteRecord> Sprites;
+
+	TConstArrayView<UE::VisualU::StoryPack::FImageRecord> Images;
+
+	TConstArrayView<uint32> ChoiceTargets;
+
+	/**
+	* Positions of nodes in the pack.
+	*/
+	TMap<FSoftObjectPath, int32> NodeIndices;
+
+};
@@ -21,6 +21,8 @@ struct VISUALU_API FDialogueTextSegment
 	FRunInfo RunInfo;
 };
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnTypewriterEnd);
+
 /**
  * A text block that exposes more information about text layout.
  * Supports break tag that pauses typewriter when it is encountered in text.
@@ -87,6 +89,16 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Visual Text Block")
 	void ForceTypewriteToEnd();
 
+	/**
+	* Called when typewriter effect is finished.
+	* 
+	* @note pausing typewriter will not trigger this event
+	* 
+	* @see UVisualTextBlock::OnTypewriterFinished()
+	*/
+	UPROPERTY(BlueprintAssignable, Category = "Visual Text Block|Events")
+	FOnTypewriterEnd OnTypewriterEnd;
+
 protected:
 	/**
 	* Called when individual letter is typed by typewriter.
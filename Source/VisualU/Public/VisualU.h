@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "Stats/Stats.h"
 
 class ISettingsSection;
 class UVisualUSettings;
@@ -13,6 +14,21 @@ class UVisualUSettings;
 */
 DECLARE_LOG_CATEGORY_EXTERN(LogVisualU, Display, All);
 
+/**
+* VisualU stat group.
+*/
+DECLARE_STATS_GROUP(TEXT("VisualU"), STATGROUP_VisualU, STATCAT_Advanced);
+
+/**
+* Time spent painting all visual images, used by SVisualImageBase.
+*/
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Paint Visual Images"), STAT_PaintVisualImages, STATGROUP_VisualU, VISUALU_API);
+
+/**
+* Number of brushes built by visual images, used by SVisualImageBase.
+*/
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Visual Image Brush Builds"), STAT_VisualImageBrushBuilds, STATGROUP_VisualU, VISUALU_API);
+
 /**
 * VisualU plugin runtime module.
 */
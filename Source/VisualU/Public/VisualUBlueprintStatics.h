@@ -15,6 +15,9 @@ class FArchive;
 struct FScenario;
 struct FAssetData;
 
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnVisualUSaved, bool, bSuccess);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnVisualULoaded, bool, bSuccess);
+
 /**
 * Blueprint library with utility functions that could be helpful while
 * developing blueprints with VisualU plugin.
@@ -62,6 +65,9 @@ public:
 
 	/**
 	* Saves VisualU contents to provided filename.
+	* Contents are compressed the same way as by SaveVisualUAsync().
+	* 
+	* @note fails until the controller can be saved, see UVisualController::CanSave()
 	* 
 	* @param VersioningSubsystem subsystem to save
 	* @param VisualController controller to save
@@ -73,6 +79,42 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "VisualU|Serialization", meta = (ToolTip = "Saves VisualU contents to provided filename."))
 	static bool SaveVisualU(UVisualVersioningSubsystem* VersioningSubsystem, UVisualController* VisualController, int32 UserIndex, const FString& Filename);
 
+	/**
+	* Saves VisualU contents to provided filename without blocking the game thread.
+	* State is captured on the game thread at the time of the call,
+	* compression and writing are done by a worker task.
+	* 
+	* @note save operations are executed one at a time. Queued save to the same file
+	*		is replaced by the newer one and both callbacks receive its result.
+	*		Fails until the controller can be saved, see UVisualController::CanSave()
+	* 
+	* @param VersioningSubsystem subsystem to save
+	* @param VisualController controller to save
+	* @param UserIndex user performing the save
+	* @param Filename file to store VisualU content
+	* @param OnSaved called on the game thread when the save is written
+	*/
+	UFUNCTION(BlueprintCallable, Category = "VisualU|Serialization", meta = (ToolTip = "Saves VisualU contents to provided filename without blocking the game thread."))
+	static void SaveVisualUAsync(UVisualVersioningSubsystem* VersioningSubsystem, UVisualController* VisualController, int32 UserIndex, const FString& Filename, FOnVisualUSaved OnSaved);
+
+	/**
+	* Loads previously saved VisualU contents from provided filename without blocking the game thread.
+	* Reading and decompression are done by a worker task,
+	* loaded contents are applied on the game thread.
+	* 
+	* @note waits for the save operations requested before it.
+	*		When nodes of the saved scenes are loaded asynchronously,
+	*		OnLoaded waits for them as well, see UVisualController::IsLoadingSavedScenes()
+	* 
+	* @param VersioningSubsystem subsystem to get the loaded data
+	* @param VisualController controller to get the loaded data
+	* @param UserIndex user performing the load
+	* @param Filename save file to load contents from
+	* @param OnLoaded called on the game thread when the contents are applied to the controller
+	*/
+	UFUNCTION(BlueprintCallable, Category = "VisualU|Serialization", meta = (ToolTip = "Loads previously saved VisualU contents from provided filename without blocking the game thread."))
+	static void LoadVisualUAsync(UVisualVersioningSubsystem* VersioningSubsystem, UVisualController* VisualController, int32 UserIndex, const FString& Filename, FOnVisualULoaded OnLoaded);
+
 	/**
 	* Requests provided data table in the controller.
 	* 
@@ -95,6 +137,11 @@ private:
 
 	/**
 	* Serializes subsystem and controller to the provided archive.
+	* Saves are written in FVisualUCustomVersion::CompactSaveFormat:
+	* header with custom versions, table of interned strings and the body.
+	* Saves without header are loaded in the legacy format.
+	* 
+	* @see FVisualUSaveArchive
 	* 
 	* @param Ar Archive to handle serialization
 	* @param VersioningSubsystem subsystem to be serialized
@@ -102,4 +149,27 @@ private:
 	*/
 	static void SerializeVisualU(FArchive& Ar, UVisualVersioningSubsystem* VersioningSubsystem, UVisualController* VisualController);
 
+	/**
+	* Applies save data, compressed or not, to subsystem and controller.
+	* 
+	* @param Data contents of the save file
+	* @param VersioningSubsystem subsystem to get the loaded data
+	* @param VisualController controller to get the loaded data
+	* @return whether or not data was read successfully
+	*/
+	static bool ReadVisualU(TArray<uint8>& Data, UVisualVersioningSubsystem* VersioningSubsystem, UVisualController* VisualController);
+
+	/**
+	* Starts the next queued save or load operation unless one is in flight.
+	*/
+	static void ProcessSaveQueue();
+
+	/**
+	* Notifies about the result of the save or load operation in flight.
+	* 
+	* @param bSuccess whether or not operation succeeded
+	* @param LoadedData contents of the save file for load operation
+	*/
+	static void CompleteSaveOperation(bool bSuccess, TArray<uint8>&& LoadedData);
+
 };
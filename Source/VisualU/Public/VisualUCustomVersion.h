@@ -12,6 +12,18 @@ public:
 
 	enum Type
 	{
+		//Before any version changes were made
+		BeforeCustomVersionWasAdded = 0,
+
+		//Save starts with a header, names and paths are interned into a string table
+		CompactSaveFormat,
+
+		//Versioning subsystem can be saved as a snapshot followed by the journal of changes, only loaded since
+		VersioningJournal,
+
+		//Versions store only altered members of the scene information
+		ScenarioInfoPatches,
+
 		//--<add new versions above this line>------------------------------------------------------------
 		VersionPlusOne,
 		LatestVersion = VersionPlusOne - 1
@@ -0,0 +1,59 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/ArchiveProxy.h"
+
+/**
+* Proxy archive for compact VisualU saves.
+* Names, object and soft object paths are interned: every unique string
+* is stored once in the string table and referred to by varint index.
+* Table is filled while saving and must be provided when loading.
+* 
+* @note objects are not loaded, only found in memory
+* 
+* @see UVisualUBlueprintStatics::SaveVisualU()
+*	   FVisualUCustomVersion::CompactSaveFormat
+*/
+class VISUALU_API FVisualUSaveArchive : public FArchiveProxy
+{
+public:
+	/**
+	* @param InInnerArchive archive with the body of the save
+	* @param InStrings table of interned strings
+	*/
+	FVisualUSaveArchive(FArchive& InInnerArchive, TArray<FString>& InStrings);
+
+	virtual FArchive& operator<<(FName& Value) override;
+
+	virtual FArchive& operator<<(UObject*& Value) override;
+
+	virtual FArchive& operator<<(FObjectPtr& Value) override;
+
+	virtual FArchive& operator<<(FWeakObjectPtr& Value) override;
+
+	virtual FArchive& operator<<(FSoftObjectPtr& Value) override;
+
+	virtual FArchive& operator<<(FSoftObjectPath& Value) override;
+
+	virtual FString GetArchiveName() const override;
+
+private:
+	/**
+	* Writes index of the string or reads string by its index.
+	* Empty string has zero index.
+	* 
+	* @param Value string to serialize
+	*/
+	void SerializeInterned(FString& Value);
+
+private:
+	TArray<FString>& Strings;
+
+	/**
+	* Positions of strings in the table, used while saving.
+	*/
+	TMap<FString, uint32> StringIndices;
+
+};
@@ -7,6 +7,7 @@
 
 class UDataTable;
 class UMaterialParameterCollection;
+class UVisualSprite;
 
 /**
 * Global plugin settings.
@@ -67,6 +68,65 @@ public:
 	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Visual Controller", meta = (ToolTip = "Data Table that contains the first scene"))
 	TSoftObjectPtr<UDataTable> FirstDataTable;
 
+	/**
+	* Whether nodes should be created from the compiled story pack instead of loading data tables.
+	* Has no effect in the editor.
+	* 
+	* @see FVisualStoryPack
+	*/
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Visual Controller|Story Pack", meta = (ToolTip = "Whether nodes should be created from the compiled story pack instead of loading data tables. Has no effect in the editor"))
+	bool bUseStoryPack;
+
+	/**
+	* Story pack file relative to the project content directory.
+	* Compiled by the VisualStoryPack commandlet, its directory must be
+	* added to additional non-asset directories to package.
+	* 
+	* @see UVisualStoryPackCommandlet
+	*/
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Visual Controller|Story Pack", meta = (EditCondition = "bUseStoryPack", ToolTip = "Story pack file relative to the project content directory. Its directory must be added to additional non-asset directories to package"))
+	FString StoryPackPath;
+
+	/**
+	* Whether loaded versions of nodes that are not in memory should be applied
+	* when the node is entered or prepared instead of loading all such nodes at once.
+	* 
+	* @see UVisualVersioningSubsystem::RestoreVersions
+	*/
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Visual Versioning", meta = (ToolTip = "Whether loaded versions should be applied when their node is entered or prepared instead of loading all versioned nodes at once"))
+	bool bLazyVersionRestore;
+
+	/**
+	* Number of hidden sprites of each class kept by UVisualRenderer for reuse in the next scenes.
+	* 
+	* @see FVisualSceneBuffer::SpritePools
+	*/
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Visual Renderer|Sprite Pool", meta = (UIMin = 0, ClampMin = 0, ToolTip = "Number of hidden sprites of each class kept by renderer for reuse in the next scenes"))
+	int32 SpritePoolSize;
+
+	/**
+	* Pool sizes of specific sprite classes.
+	*/
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Visual Renderer|Sprite Pool", meta = (ToolTip = "Pool sizes of specific sprite classes"))
+	TMap<TSoftClassPtr<UVisualSprite>, int32> SpritePoolSizeOverrides;
+
+	/**
+	* Whether UVisualRenderer should build the next scene in a hidden canvas
+	* while the current one is displayed, so that advancing only swaps the canvases.
+	* 
+	* @see UVisualRenderer::PreDrawScene
+	*/
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Visual Renderer", meta = (ToolTip = "Whether renderer should build the next scene in a hidden canvas while the current one is displayed"))
+	bool bDoubleBufferedRenderer;
+
+	/**
+	* Time in milliseconds UVisualRenderer may spend per frame on constructing and updating sprites of the scene.
+	* Sprites that don't fit into the budget are processed on the next frames, in order of their ZOrder.
+	* Zero means that all sprites are processed at once.
+	*/
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Visual Renderer", meta = (UIMin = 0, ClampMin = 0, Units = "Milliseconds", ToolTip = "Time renderer may spend per frame on constructing sprites of the scene, zero means no limit"))
+	float SpriteConstructionBudget;
+
 	/**
 	* Material parameter collection used for transition material.
 	* First scalar parameter from this collection will be used
@@ -9,6 +9,7 @@
 #include "Engine/DataTable.h"
 #include "VisualController.h"
 #include "VisualTemplates.h"
+#include "ScenarioInfoPatch.h"
 #include "VisualVersioningSubsystem.generated.h"
 
 class UDataTable;
@@ -45,6 +46,44 @@ private:
 			return !(Id == Other);
 		}
 	};
+
+	/**
+	* Type of the change recorded in the journal of older saves.
+	*/
+	enum class EJournalOp : uint8
+	{
+		/*Previous information becomes a version, scene gets recorded information*/
+		Alter,
+
+		/*Scene is switched to an older version*/
+		Checkout
+	};
+
+	/**
+	* Change recorded in the journal of older saves.
+	*/
+	struct FJournalRecord
+	{
+		FScenarioId Id;
+		EJournalOp Op;
+
+		/*Altered members of the scene, unused for checkout*/
+		FScenarioInfoPatch Patch;
+	};
+
+	/**
+	* Loaded versions of the scene which node is not restored yet.
+	*/
+	struct FPendingScene
+	{
+		/*Versions and information of the scene, valid when bHasSnapshot is set*/
+		TArray<FScenarioInfoPatch> Patches;
+		FVisualScenarioInfo Info;
+		bool bHasSnapshot = false;
+
+		/*Journal records to replay after the snapshot*/
+		TArray<FJournalRecord> Records;
+	};
 	
 public:
 	UVisualVersioningSubsystem();
@@ -70,9 +109,10 @@ public:
 	template<typename T = FVisualScenarioInfo, typename... V>
 	inline void AlterDataTable(const UDataTable* DataTable, const FName& SceneName, V T::*... Members, const V&... Values)
 	{
+		RestoreVersions(DataTable);
 		FScenario* Scene = GetSceneChecked(DataTable, SceneName);
-		FScenarioId Id{ Scene->GetOwner(), Scene->GetIndex() };
-		Versions.Add(Id, Scene->Info);
+		const EScenarioInfoMembers AlteredMembers = FScenarioInfoPatch::GetMembers<V...>(Members...);
+		AddVersion(FScenarioId{ Scene->GetOwner(), Scene->GetIndex() }, FScenarioInfoPatch(Scene->Info, AlteredMembers));
 		UpdateMembers<T, V...>(&Scene->Info, Members..., Values...);
 	}
 
@@ -85,8 +125,9 @@ public:
 	inline void AlterDataTable(FScenario* Scene, V T::*... Members, const V&... Values)
 	{
 		check(Scene);
-		FScenarioId Id{ Scene->GetOwner(), Scene->GetIndex() };
-		Versions.Add(Id, Scene->Info);
+		RestoreVersions(Scene->GetOwner());
+		const EScenarioInfoMembers AlteredMembers = FScenarioInfoPatch::GetMembers<V...>(Members...);
+		AddVersion(FScenarioId{ Scene->GetOwner(), Scene->GetIndex() }, FScenarioInfoPatch(Scene->Info, AlteredMembers));
 		UpdateMembers<T, V...>(&Scene->Info, Members..., Values...);
 	}
 
@@ -106,9 +147,30 @@ public:
 	*/
 	void CheckoutAll(const UDataTable* DataTable) const;
 
+	/**
+	* Switches all scenes in the data tables to an older version.
+	* Only scenes altered by this subsystem are visited.
+	*
+	* @param DataTables nodes which scenes will be reverted to previous version
+	*/
+	void CheckoutAll(TConstArrayView<const UDataTable*> DataTables) const;
+
+	/**
+	* Applies loaded versions of scenes in the data table.
+	* With UVisualUSettings::bLazyVersionRestore, versions of nodes that are not in memory
+	* are kept by this subsystem until the node is entered or prepared by UVisualController.
+	* Has no effect for the data table without such versions.
+	*
+	* @param DataTable node which versions should be restored
+	*/
+	void RestoreVersions(const UDataTable* DataTable);
+
 	/**
 	* Serializes versioning subsystem to the provided archive.
 	* Uses FVisualUCustomVersion.
+	* 
+	* @note saves written with FVisualUCustomVersion::VersioningJournal might store
+	*		versions as a snapshot followed by the journal of changes, such saves are still loaded
 	*
 	* @param Ar archive to serialize this subsystem
 	*/
@@ -146,10 +208,85 @@ private:
 	*/
 	FScenario* GetSceneChecked(const FScenarioId& Id) const;
 
+	/**
+	* Stores previous version of the scene.
+	*
+	* @param Id identity of the altered scene
+	* @param Version altered members of the scene before alteration
+	*/
+	void AddVersion(const FScenarioId& Id, FScenarioInfoPatch&& Version);
+
+	/**
+	* Switches the scene to its latest version.
+	*
+	* @param Id identity of the scene
+	* @param Scene scene to switch
+	* @return {@code true} when the scene has a version
+	*/
+	bool ApplyCheckout(const FScenarioId& Id, FScenario& Scene) const;
+
+	/**
+	* Serializes all versions of all altered scenes.
+	*
+	* @param Ar archive to serialize versions
+	*/
+	void SerializeVersions(FArchive& Ar);
+
+	/**
+	* Loads journal record and applies it to the scene.
+	*
+	* @param Ar archive to load the record from
+	* @param Record loaded record
+	*/
+	void LoadRecord(FArchive& Ar, FJournalRecord& Record);
+
+	/**
+	* Applies journal record to the scene.
+	*
+	* @param Scene scene identified by the record
+	* @param Record record to apply
+	*/
+	void ApplyRecord(FScenario& Scene, const FJournalRecord& Record);
+
+	/**
+	* Serializes identity of the scene in the same layout as FScenario,
+	* without loading its node.
+	*
+	* @param Ar archive to serialize the identity
+	* @param Id identity of the scene
+	*/
+	static void SerializeSceneId(FArchive& Ar, FScenarioId& Id);
+
+	/**
+	* @param Ar archive with versions
+	* @return whether or not loaded versions can be kept until their node is restored
+	*/
+	static bool CanRestoreLazily(const FArchive& Ar);
+
+	/**
+	* @param Id identity of the loaded scene
+	* @param bRestoreLazily whether or not new pending scene can be added
+	* @return pending scene to keep loaded versions in or nullptr when they must be applied
+	*/
+	FPendingScene* FindPendingScene(const FScenarioId& Id, bool bRestoreLazily);
+
 private:
 	/**
 	* Map of scenes to all versions of their information.
+	* Each version stores only members changed by the alteration,
+	* latest version reverts the scene to its state before the last alteration.
+	*/
+	TMultiMap<FScenarioId, FScenarioInfoPatch> Versions;
+
+	/**
+	* Indices of altered scenes in each node.
+	* Allows checkout to visit only scenes that have versions.
+	*/
+	TMap<TSoftObjectPtr<const UDataTable>, TSet<int32>> VersionedScenes;
+
+	/**
+	* Loaded versions of nodes that are not restored yet, by position of the scene.
 	*/
-	TMultiMap<FScenarioId, FVisualScenarioInfo> Versions;
+	TMap<TSoftObjectPtr<const UDataTable>, TMap<int32, FPendingScene>> PendingScenes;
 
 };
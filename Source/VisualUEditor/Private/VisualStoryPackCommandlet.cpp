@@ -0,0 +1,74 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+
+#include "VisualStoryPackCommandlet.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/DataTable.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Scenario.h"
+#include "VisualStoryPack.h"
+#include "VisualUSettings.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVisualStoryPack, Log, All);
+
+UVisualStoryPackCommandlet::UVisualStoryPackCommandlet()
+	: Super()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UVisualStoryPackCommandlet::Main(const FString& Params)
+{
+	FString Output;
+	if (!FParse::Value(*Params, TEXT("Output="), Output))
+	{
+		Output = FPaths::ProjectContentDir() / GetDefault<UVisualUSettings>()->StoryPackPath;
+	}
+
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	AssetRegistry.SearchAllAssets(/*bSynchronousSearch=*/true);
+
+	TArray<FAssetData> DataTableAssets;
+	AssetRegistry.GetAssetsByClass(UDataTable::StaticClass()->GetClassPathName(), DataTableAssets);
+
+	/*Sorted to produce the same pack for the same content*/
+	DataTableAssets.Sort([](const FAssetData& A, const FAssetData& B)
+	{
+		return A.GetSoftObjectPath().LexicalLess(B.GetSoftObjectPath());
+	});
+
+	TArray<const UDataTable*> Nodes;
+	for (const FAssetData& DataTableAsset : DataTableAssets)
+	{
+		const UDataTable* DataTable = Cast<UDataTable>(DataTableAsset.GetAsset());
+		if (!DataTable || !DataTable->GetRowStruct() || !DataTable->GetRowStruct()->IsChildOf(FScenario::StaticStruct()))
+		{
+			continue;
+		}
+
+		if (DataTable->GetRowStruct() != FScenario::StaticStruct())
+		{
+			UE_LOG(LogVisualStoryPack, Warning, TEXT("%s is based on %s and can't be packed, it will be loaded as data table."), *DataTable->GetPathName(), *DataTable->GetRowStruct()->GetName());
+			continue;
+		}
+
+		Nodes.Add(DataTable);
+	}
+
+	TArray<uint8> StoryPack;
+	const int32 NumPackedNodes = FVisualStoryPack::Write(Nodes, StoryPack);
+
+	if (!FFileHelper::SaveArrayToFile(StoryPack, *Output))
+	{
+		UE_LOG(LogVisualStoryPack, Error, TEXT("Unable to write story pack to %s."), *Output);
+		return 1;
+	}
+
+	UE_LOG(LogVisualStoryPack, Display, TEXT("Packed %i nodes into %s (%i bytes)."), NumPackedNodes, *Output, StoryPack.Num());
+
+	return 0;
+}
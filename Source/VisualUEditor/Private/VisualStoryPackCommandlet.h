@@ -0,0 +1,28 @@
+// Copyright (c) 2024 Evgeny Shustov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "VisualStoryPackCommandlet.generated.h"
+
+/**
+* Compiles all nodes of the project into the story pack.
+* Should be run before cooking, so the pack matches cooked data tables:
+* {@code UnrealEditor-Cmd <Project>.uproject -run=VisualStoryPack [-Output=<File>]}
+* 
+* @note by default pack is written to UVisualUSettings::StoryPackPath
+* 
+* @see FVisualStoryPack
+*/
+UCLASS()
+class UVisualStoryPackCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UVisualStoryPackCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+};
@@ -23,7 +23,8 @@ public class VisualUEditor : ModuleRules
                 "Engine",
                 "Slate",
 				"SlateCore",
-				"PropertyEditor"
+				"PropertyEditor",
+				"AssetRegistry"
 			}
 			);
 		